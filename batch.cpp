@@ -0,0 +1,160 @@
+#include <string>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include <cstdio>
+#include "batch.h"
+#include "graph.h"
+#include "bfs.h"
+#include "properties.h"
+#include "formats.h"
+#include "pool.h"
+
+using namespace std;
+
+/* Graphs are read and checked in chunks of this many records. */
+static const size_t CHUNK = 4096;
+
+/* Memory reused by a worker for all its graphs. */
+struct Scratch {
+	Graph G;
+	BFSScratch bfs;
+};
+
+/* Input record: one graph6/sparse6 line or a TGF graph. */
+struct Record {
+	bool tgf;
+	string text;
+};
+
+static bool read_record(istream& in, Record& r) {
+	string line;
+	r.text.clear();
+	while (getline(in, line)) {
+		if (!line.empty() && line.back() == '\r') {
+			line.pop_back();
+		}
+		if (r.text.empty() && line.empty()) {
+			continue;
+		} else if (r.text.empty() && is_graph6(line)) {
+			r.tgf = false;
+			r.text = line;
+			return true;
+		} else if (line.empty()) {
+			return true;
+		}
+		r.tgf = true;
+		r.text += line;
+		r.text += '\n';
+	}
+	return !r.text.empty();
+}
+
+/* Escape a string for JSON. */
+static string json_string(const string& text) {
+	string quoted = "\"";
+	for (char c: text) {
+		if (c == '"' || c == '\\') {
+			quoted += '\\';
+			quoted += c;
+		} else if ((unsigned char) c < 0x20) {
+			char code[8];
+			snprintf(code, sizeof(code), "\\u%04x", c);
+			quoted += code;
+		} else {
+			quoted += c;
+		}
+	}
+	return quoted + "\"";
+}
+
+/* Format a value that can be infinite. */
+static string value(int x, BatchFormat format) {
+	if (x == INF) {
+		return (format == BatchFormat::CSV) ? "inf" : "null";
+	}
+	ostringstream out; out << x;
+	return out.str();
+}
+
+static string check_record(size_t index, const Record& r, Scratch& s, BatchFormat format, double budget) {
+	Graph& G = s.G;
+	ostringstream out;
+	try {
+		if (r.tgf) {
+			istringstream in(r.text);
+			G = Graph(in);
+		} else {
+			read_graph6(r.text, G);
+		}
+	} catch (exception& e) {
+		if (format == BatchFormat::CSV) {
+			out << index << ",error\n";
+		} else {
+			out << "{\"index\": " << index << ", \"error\": " << json_string(e.what()) << "}\n";
+		}
+		return out.str();
+	}
+
+	/* One budget for all properties of the graph; the BFS runs use the
+	   worker's buffers. */
+	Budget graph_budget(budget);
+	int n = G.nnodes();
+	int max_degree = (n > 0) ? G.degree(maximum_degree(G)) : 0;
+	Bounds d = diam(G, graph_budget, s.bfs);
+	Bounds g = girth(G, graph_budget, s.bfs);
+	Bounds chi = chromatic_number(G, graph_budget);
+
+	if (format == BatchFormat::CSV) {
+		out << index << "," << n << "," << G.nedges() << "," << max_degree << ","
+		    << value(d.lower, format) << "," << value(d.upper, format) << ","
+		    << value(g.lower, format) << "," << value(g.upper, format) << ","
+		    << chi.lower << "," << chi.upper << "\n";
+	} else {
+		out << "{\"index\": " << index << ", \"n\": " << n << ", \"m\": " << G.nedges()
+		    << ", \"max_degree\": " << max_degree
+		    << ", \"diam\": [" << value(d.lower, format) << ", " << value(d.upper, format) << "]"
+		    << ", \"girth\": [" << value(g.lower, format) << ", " << value(g.upper, format) << "]"
+		    << ", \"chromatic_number\": [" << chi.lower << ", " << chi.upper << "]}\n";
+	}
+	return out.str();
+}
+
+void check_batch(istream& in, ostream& out, BatchFormat format, int njobs, double budget) {
+	if (format == BatchFormat::CSV) {
+		out << "index,n,m,max_degree,diam_lower,diam_upper,girth_lower,girth_upper,"
+		    << "chromatic_lower,chromatic_upper\n";
+	}
+
+	ThreadPool pool(njobs);
+	vector<Scratch> scratch(pool.size());
+	vector<Record> records(CHUNK);
+	vector<string> results(CHUNK);
+	size_t first = 0;
+	for (;;) {
+		size_t count = 0;
+		while (count < CHUNK && read_record(in, records[count])) {
+			count++;
+		}
+		if (count == 0) {
+			break;
+		}
+
+		/* Worker t checks records t, t + #workers, ... */
+		vector<future<void>> done;
+		for (int t = 0; t < pool.size(); ++t) {
+			done.push_back(pool.submit([&, t, count] () {
+				for (size_t i = t; i < count; i += pool.size()) {
+					results[i] = check_record(first + i, records[i], scratch[t], format, budget);
+				}
+			}));
+		}
+		for (auto& d: done) {
+			d.get();
+		}
+		for (size_t i = 0; i < count; ++i) {
+			out << results[i];
+		}
+		first += count;
+	}
+}
@@ -0,0 +1,19 @@
+#ifndef _BATCH_H
+#define _BATCH_H
+
+#include <iostream>
+
+/** batch.h: Checking many (small) graphs in one run. */
+
+enum class BatchFormat { CSV, JSON };
+
+/**
+ * Reads a stream of graphs from in, either graph6/sparse6 lines or TGF graphs
+ * separated by empty lines, checks them on njobs threads (<= 0: one per core)
+ * and writes one record per graph to out in input order: order, size, max.
+ * degree and bounds for the diameter, girth and chromatic number, which
+ * together get budget seconds per graph.
+ */
+void check_batch(std::istream& in, std::ostream& out, BatchFormat format, int njobs, double budget);
+
+#endif
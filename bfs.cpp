@@ -1,10 +1,81 @@
 #include <queue>
+#include <atomic>
+#include <thread>
+#include <cstdint>
 #include <utility>
 #include "bfs.h"
 
 using namespace std;
 
-void bfs(const Graph& G, Node u, const BFSFunc& f) {
+/* Levels with fewer nodes per thread are expanded sequentially. */
+static const size_t MIN_PARALLEL_LEVEL = 1024;
+
+/* Level-synchronous parallel BFS. Threads take chunks of the current level,
+   claim unvisited neighbours by setting their bit in the visited bitmap
+   atomically and collect them in thread-local buffers. */
+template <class GraphT>
+static void parallel_bfs(const GraphT& G, Node u, const BFSFunc& f, int nthreads) {
+	const size_t CHUNK = 256;
+	vector<atomic<uint64_t>> visited((G.nnodes() + 63) / 64);
+	auto claim = [&] (Node v) {
+		uint64_t bit = uint64_t(1) << (v % 64);
+		atomic<uint64_t>& word = visited[v / 64];
+		return !(word.load(memory_order_relaxed) & bit)
+		    && !(word.fetch_or(bit, memory_order_relaxed) & bit);
+	};
+
+	vector<vector<Node>> local(nthreads);
+	vector<Node> level{u}, next;
+	claim(u);
+	for (Dist d = 0; !level.empty(); ++d) {
+		for (Node a: level) {
+			f(a, d);
+		}
+
+		/* Expand the level. */
+		atomic<size_t> pos(0);
+		auto expand = [&] (int t) {
+			vector<Node>& out = local[t];
+			out.clear();
+			for (size_t i; (i = pos.fetch_add(CHUNK)) < level.size(); ) {
+				for (size_t j = i; j < min(i + CHUNK, level.size()); ++j) {
+					for (Node b: G.neighbours(level[j])) {
+						if (claim(b)) {
+							out.push_back(b);
+						}
+					}
+				}
+			}
+		};
+		int nworkers = int(min(size_t(nthreads), level.size() / MIN_PARALLEL_LEVEL + 1));
+		vector<thread> workers;
+		for (int t = 1; t < nworkers; ++t) {
+			workers.emplace_back(expand, t);
+		}
+		expand(0);
+		for (thread& w: workers) {
+			w.join();
+		}
+
+		next.clear();
+		for (int t = 0; t < nworkers; ++t) {
+			next.insert(end(next), begin(local[t]), end(local[t]));
+		}
+		swap(level, next);
+	}
+}
+
+/* BFS on Graph or CompressedGraph. */
+template <class GraphT>
+static void bfs_impl(const GraphT& G, Node u, const BFSFunc& f, int nthreads) {
+	if (nthreads <= 0) {
+		nthreads = max(1u, thread::hardware_concurrency());
+	}
+	if (nthreads > 1) {
+		parallel_bfs(G, u, f, nthreads);
+		return;
+	}
+
 	vector<Dist> dist(G.nnodes(), INF);
 	queue<Node> visit;
 
@@ -16,22 +87,60 @@ void bfs(const Graph& G, Node u, const BFSFunc& f) {
 		Node a = visit.front();	visit.pop();
 		f(a, dist[a]);
 
-		G.for_neighbours(a, [&] (Node b) {
+		for (Node b: G.neighbours(a)) {
 			if (dist[b] == INF) {
 				dist[b] = dist[a] + 1;
 				visit.push(b);
 			}
-		});
+		}
 	}
 }
 
-Dist distance(const Graph& G, Node u, Node v) {
+void bfs(const Graph& G, Node u, const BFSFunc& f, int nthreads) {
+	bfs_impl(G, u, f, nthreads);
+}
+
+void bfs(const CompressedGraph& G, Node u, const BFSFunc& f, int nthreads) {
+	bfs_impl(G, u, f, nthreads);
+}
+
+void bfs(const Graph& G, Node u, const BFSFunc& f, BFSScratch& scratch) {
+	vector<Dist>& dist = scratch.dist;
+	vector<Node>& visit = scratch.queue;
+	dist.assign(G.nnodes(), INF);
+	visit.clear();
+
+	dist[u] = 0;
+	visit.push_back(u);
+	for (size_t head = 0; head < visit.size(); ++head) {
+		Node a = visit[head];
+		f(a, dist[a]);
+
+		for (Node b: G.neighbours(a)) {
+			if (dist[b] == INF) {
+				dist[b] = dist[a] + 1;
+				visit.push_back(b);
+			}
+		}
+	}
+}
+
+template <class GraphT>
+static Dist distance_impl(const GraphT& G, Node u, Node v, int nthreads) {
 	Dist dist = INF;
 	bfs(G, u, [&] (Node w, Dist d) {
 		if (w == v) {
 			dist = d;
 			/* Note: As an optimisation you can actually stop the BFS now. */
 		}
-	});
+	}, nthreads);
 	return dist;
 }
+
+Dist distance(const Graph& G, Node u, Node v, int nthreads) {
+	return distance_impl(G, u, v, nthreads);
+}
+
+Dist distance(const CompressedGraph& G, Node u, Node v, int nthreads) {
+	return distance_impl(G, u, v, nthreads);
+}
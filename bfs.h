@@ -3,15 +3,33 @@
 
 #include <functional>
 #include "graph.h"
+#include "compressed.h"
 
 /**
  * BFS from u on G that calls f for each visited node v.
  * f gets the node v and the distance d(u, v).
+ *
+ * nthreads != 1 runs a level-synchronous BFS on nthreads threads (<= 0: one
+ * per core). f is still called from the calling thread, exactly once per node and
+ * with nondecreasing distances, but the order within a level is unspecified.
+ * f may throw (e.g. Timeout) to abort the search.
  */
 typedef std::function<void(Node, Dist)> BFSFunc;
-void bfs(const Graph& G, Node u, const BFSFunc& f);
+void bfs(const Graph& G, Node u, const BFSFunc& f, int nthreads = 1);
+void bfs(const CompressedGraph& G, Node u, const BFSFunc& f, int nthreads = 1);
+
+/* Sequential BFS reusing the buffers in scratch, e.g. one per worker thread
+   that checks many small graphs. */
+struct BFSScratch {
+	std::vector<Dist> dist;     /* Distance from the source. */
+	std::vector<Node> queue;    /* Visited nodes in BFS order. */
+	std::vector<Node> parent;   /* BFS tree, for searches that need one (not
+	                               filled by bfs()). */
+};
+void bfs(const Graph& G, Node u, const BFSFunc& f, BFSScratch& scratch);
 
 /** Computes the distance between u and v in G. */
-Dist distance(const Graph& G, Node u, Node v);
+Dist distance(const Graph& G, Node u, Node v, int nthreads = 1);
+Dist distance(const CompressedGraph& G, Node u, Node v, int nthreads = 1);
 
 #endif
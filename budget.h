@@ -0,0 +1,65 @@
+#ifndef _BUDGET_H
+#define _BUDGET_H
+
+#include <chrono>
+#include <stdexcept>
+
+/** budget.h: Time budgets for the cooperative cancellation of long computations. */
+
+/* Thrown by Budget::check() once the budget is used up. */
+struct Timeout : public std::runtime_error {
+	Timeout() : std::runtime_error("Time budget exceeded") {}
+};
+
+/**
+ * Deadline for a computation, optionally nested in a parent budget (e.g. a
+ * per-property budget within a global one). Long-running loops call check()
+ * regularly, which throws Timeout once this or any parent budget expired.
+ */
+class Budget {
+private:
+	typedef std::chrono::steady_clock Clock;
+	Clock::time_point deadline;
+	bool limited;
+	const Budget* parent;
+
+public:
+	/* Unlimited budget. */
+	Budget() : deadline(), limited(false), parent(nullptr) {}
+
+	/* Budget of the given number of seconds (<= 0: unlimited) within parent. */
+	explicit Budget(double seconds, const Budget* parent = nullptr)
+		: deadline(Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds))),
+		  limited(seconds > 0), parent(parent) {}
+
+	bool expired() const {
+		return (limited && Clock::now() >= deadline) || (parent && parent->expired());
+	}
+
+	void check() const {
+		if (expired()) {
+			throw Timeout();
+		}
+	}
+};
+
+/**
+ * Amortised budget checks for hot loops and recursions: only every 1024th
+ * call of check() reads the clock(s). One per thread, it is not shared.
+ */
+class Ticker {
+private:
+	const Budget& budget;
+	unsigned ticks;
+
+public:
+	explicit Ticker(const Budget& budget) : budget(budget), ticks(0) {}
+
+	void check() {
+		if ((++ticks & 1023) == 0) {
+			budget.check();
+		}
+	}
+};
+
+#endif
@@ -1,7 +1,19 @@
 #include <iostream>
+#include <fstream>
 #include <sstream>
+#include <cstdlib>
+#include <algorithm>
+#include <map>
+#include <future>
+#include <functional>
+#include <stdexcept>
 #include "graph.h"
 #include "properties.h"
+#include "compressed.h"
+#include "reorder.h"
+#include "stream.h"
+#include "pool.h"
+#include "batch.h"
 
 using namespace std;
 
@@ -16,62 +28,238 @@ string inf(int n) {
 	return out.str();
 }
 
+/** Format bounds, noting that the exact value is unknown if they differ. */
+string bounds(Bounds b) {
+	if (b.lower == b.upper) {
+		return inf(b.lower);
+	}
+	return "[" + inf(b.lower) + ", " + inf(b.upper) + "] (out of time or too large)";
+}
+
+/** Streaming mode: statistics of a TGF graph in O(n) memory, optionally
+    followed by conversion to a CSR file (needs a file to read twice). */
+int check_stream(istream& in, const string& filename, const string& csr) {
+	StreamSummary s = stream_analyse(in);
+	cout << "n = " << s.n << "\n";
+	cout << "m = " << s.m << "\n";
+	if (s.n > 0) {
+		auto max_node = max_element(begin(s.degree), end(s.degree));
+		cout << "degree: min " << *min_element(begin(s.degree), end(s.degree)) << ", avg " << 2.0 * s.m / s.n
+		     << ", max " << *max_node << " (node " << max_node - begin(s.degree) + 1 << ")\n";
+	}
+	cout << "components = " << s.components << "\n";
+	cout << "Forest: " << (s.forest ? "Yes" : "No") << "\n";
+	cout << "Bipartite: " << (s.bipartite ? "Yes" : "No") << "\n";
+
+	if (csr != "") {
+		if (filename == "") {
+			cerr << "--csr needs the graph as file argument\n";
+			return 1;
+		}
+		ifstream again(filename);
+		write_csr(again, s, csr);
+		cout << "CSR written to " << csr << "\n";
+	}
+	return 0;
+}
+
 /** check.cpp: Program for determining some properties of a graph in TGF format. */
 int main(int argc, char** argv) {
-	cout << "Usage: " << argv[0] << " < graph.tgf\n";
+	/* Options. */
+	Order order = Order::AUTO;
+	int nthreads = 1;
+	int njobs = 0;
+	bool compress = false, streaming = false, approx = false, batch = false, verify = false;
+	BatchFormat batch_format = BatchFormat::CSV;
+	double approx_budget = 0, per_property = 10, total_time = 0;
+	string filename, csr;
+	for (int i = 1; i < argc; ++i) {
+		string arg = argv[i];
+		if (arg.compare(0, 8, "--order=") == 0) {
+			try {
+				order = parse_order(arg.substr(8));
+			} catch (const runtime_error&) {
+				cerr << "Unknown option '" << arg << "'\n";
+				return 1;
+			}
+		} else if (arg.compare(0, 10, "--threads=") == 0) {
+			nthreads = atoi(arg.c_str() + 10);
+		} else if (arg == "--compress") {
+			compress = true;
+		} else if (arg == "--approx" || arg.compare(0, 9, "--approx=") == 0) {
+			approx = true;
+			approx_budget = (arg.size() > 9) ? atof(arg.c_str() + 9) : 0;
+		} else if (arg.compare(0, 7, "--jobs=") == 0) {
+			njobs = atoi(arg.c_str() + 7);
+		} else if (arg.compare(0, 7, "--time=") == 0) {
+			per_property = atof(arg.c_str() + 7);
+		} else if (arg.compare(0, 13, "--total-time=") == 0) {
+			total_time = atof(arg.c_str() + 13);
+		} else if (arg == "--batch" || arg == "--batch=csv" || arg == "--batch=json") {
+			batch = true;
+			batch_format = (arg == "--batch=json") ? BatchFormat::JSON : BatchFormat::CSV;
+		} else if (arg == "--verify-symmetry") {
+			verify = true;
+		} else if (arg == "--stream") {
+			streaming = true;
+		} else if (arg.compare(0, 6, "--csr=") == 0) {
+			csr = arg.substr(6);
+		} else if (arg.compare(0, 2, "--") != 0 && filename == "") {
+			filename = arg;
+		} else {
+			cerr << "Unknown option '" << arg << "'\n";
+			return 1;
+		}
+	}
+
+	/* The output of batch mode is meant for further processing. */
+	if (!batch) {
+		cout << "Usage: " << argv[0] << " [options, see README] [graph.tgf | graph.csr] (default: TGF from stdin)\n";
+	}
+
+	/* Input: stdin or file, CSR files are recognised by their extension. */
+	ifstream file;
+	if (filename != "") {
+		file.open(filename, ios::binary);
+		if (!file) {
+			cerr << "Cannot read '" << filename << "'\n";
+			return 1;
+		}
+	}
+	istream& in = (filename != "") ? file : cin;
+	bool is_csr = filename.size() > 4 && filename.compare(filename.size() - 4, 4, ".csr") == 0;
+	if (streaming) {
+		return check_stream(in, filename, csr);
+	} else if (batch) {
+		check_batch(in, cout, batch_format, njobs, per_property);
+		return 0;
+	} else if (compress && is_csr && !approx) {
+		/* Only the diameter, on adjacency lists compressed straight from
+		   the CSR file: the Graph is never built. */
+		try {
+			CompressedGraph C(in);
+			cout << "n = " << C.nnodes() << "\n";
+			cout << "m = " << C.nedges() << "\n";
+			cout << "compressed: " << C.bytes_per_edge() << " bytes/edge\n";
+			Budget total(total_time), budget(per_property, &total);
+			cout << "diam = " << bounds(diam(C, budget, nthreads)) << "\n";
+		} catch (const runtime_error& e) {
+			cerr << e.what() << "\n";
+			return 1;
+		}
+		return 0;
+	}
 
-	/* Read graph. */
-	Graph G(cin);
+	/* Read graph and relabel it for cache locality (labels move with the nodes). */
+	Graph G = reorder(is_csr ? read_csr(in) : Graph(in), order).G;
 
 	/* Order and size. */
 	cout << "n = " << G.nnodes() << "\n";
 	cout << "m = " << G.nedges() << "\n";
 
-	/* Diameter */
-	cout << "diam = " << inf(diam(G)) << "\n";
+	/* Independent properties run concurrently, each with its own budget
+	   within the global one; results are printed in a fixed order. */
+	Budget total(total_time);
+	ThreadPool pool(njobs);
+	vector<future<string>> results;
+	auto property = [&] (function<string(const Budget&)> f) {
+		results.push_back(pool.submit([&total, per_property, f] () {
+			Budget budget(per_property, &total);
+			return f(budget);
+		}));
+	};
+
+	/* Diameter: bounds from few BFS runs, or exact (optionally on the
+	   compressed adjacency lists). */
+	property([&] (const Budget& budget) {
+		ostringstream out;
+		if (approx) {
+			DiamBounds b = approx_diam(G, 16, approx_budget, nthreads, budget);
+			out << "diam in [" << inf(b.lower) << ", " << inf(b.upper) << "] (" << b.nbfs << " BFS runs)\n";
+			if (!b.sampled.empty()) {
+				map<Dist, int> hist;
+				for (Dist ecc: b.sampled) {
+					hist[ecc]++;
+				}
+				out << "eccentricities of " << b.sampled.size() << " sampled nodes:";
+				for (auto h: hist) {
+					out << " " << h.first << " (" << 100.0 * h.second / b.sampled.size() << "%)";
+				}
+				out << "\n";
+			}
+		} else if (compress) {
+			CompressedGraph C(G);
+			out << "compressed: " << C.bytes_per_edge() << " bytes/edge\n";
+			out << "diam = " << bounds(diam(C, budget, nthreads)) << "\n";
+		} else {
+			out << "diam = " << bounds(diam(G, budget, nthreads)) << "\n";
+		}
+		return out.str();
+	});
 
 	/* Girth */
-	cout << "girth = " << inf(girth(G)) << "\n";
-
-	/* Hamiltonicity. */
-	cout << "Hamiltonian: ";
-	if (G.nnodes() <= 16) {
-		bool is_hamiltonian;
-		vector<Node> tour;
-		tie(is_hamiltonian, tour) = hamiltonian_tour(G);
-		cout << (is_hamiltonian ? "Yes" : "No");
-		if (is_hamiltonian) {
-			cout << " (";
-			for (Node u: tour) {
-				cout << G.label(u);
-				if (u != 0) {
-					cout << ", ";
+	property([&] (const Budget& budget) {
+		return "girth = " + bounds(girth(G, budget)) + "\n";
+	});
+
+	/* Hamiltonicity (the memoisation needs n * 2^n bits). */
+	property([&] (const Budget& budget) {
+		ostringstream out;
+		out << "Hamiltonian: ";
+		if (G.nnodes() > 0 && G.nnodes() <= 24) {
+			try {
+				bool is_hamiltonian;
+				vector<Node> tour;
+				tie(is_hamiltonian, tour) = hamiltonian_tour(G, budget);
+				out << (is_hamiltonian ? "Yes" : "No");
+				if (is_hamiltonian) {
+					out << " (";
+					for (Node u: tour) {
+						out << G.label(u);
+						if (u != 0) {
+							out << ", ";
+						}
+					}
+					out << ")";
 				}
+			} catch (Timeout&) {
+				out << "unknown (time budget exceeded)";
 			}
-			cout << ")";
+		} else {
+			out << "not checked";
 		}
-	} else {
-		cout << "not checked";
-	}
-	cout << "\n";
+		out << "\n";
+		return out.str();
+	});
 
-	/* Chromatic number. */
-	cout << "Chromatic number: ";
-	if (G.nnodes() <= 16) {
-		cout << chromatic_number(G);
-	} else {
-		cout << "not checked";
+	/* Chromatic number and index. */
+	property([&] (const Budget& budget) {
+		return "Chromatic number: " + bounds(chromatic_number(G, budget)) + "\n";
+	});
+	property([&] (const Budget& budget) {
+		return "Chromatic index: " + bounds(chromatic_index(G, budget)) + "\n";
+	});
+
+	/* Cross-check the shortcuts for symmetric graphs with the full computation. */
+	if (verify && !G.orbits().empty()) {
+		property([&] (const Budget& budget) {
+			Graph H = G;
+			H.set_orbits({});
+			Bounds d1 = diam(G, budget, nthreads), d2 = diam(H, budget, nthreads);
+			Bounds g1 = girth(G, budget), g2 = girth(H, budget);
+			if (d1.lower != d1.upper || d2.lower != d2.upper || g1.lower != g1.upper || g2.lower != g2.upper) {
+				return string("Symmetry: not verified (time budget exceeded)\n");
+			} else if (d1.lower != d2.lower || g1.lower != g2.lower) {
+				return "Symmetry: MISMATCH (diam " + inf(d1.lower) + " vs. " + inf(d2.lower)
+				     + ", girth " + inf(g1.lower) + " vs. " + inf(g2.lower) + ")\n";
+			}
+			return string("Symmetry: verified\n");
+		});
 	}
-	cout << "\n";
 
-	/* Chromatic index. */
-	cout << "Chromatic index: ";
-	if (G.nnodes() <= 16) {
-		cout << chromatic_index(G);
-	} else {
-		cout << "not checked";
+	for (auto& result: results) {
+		cout << result.get();
 	}
-	cout << "\n";
 
 	return 0;
 }
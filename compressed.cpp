@@ -0,0 +1,135 @@
+#include <set>
+#include <algorithm>
+#include <stdexcept>
+#include "compressed.h"
+
+using namespace std;
+
+/* Appends x as varint. */
+static void encode(vector<uint8_t>& out, uint32_t x) {
+	while (x >= 0x80) {
+		out.push_back(uint8_t(x | 0x80));
+		x >>= 7;
+	}
+	out.push_back(uint8_t(x));
+}
+
+CompressedGraph::CompressedGraph(const Graph& G)
+	: data(), base(), offset(), orbit(G.orbits()), n(G.nnodes()), m(G.nedges()) {
+	base.reserve(n / 64 + 1);
+	offset.reserve(n);
+	data.reserve(n + 2 * size_t(m));
+
+	vector<Node> adj;
+	for (Node u = 0; u < n; ++u) {
+		Graph::NodeRange range = G.neighbours(u);
+		adj.assign(range.begin(), range.end());
+		append(u, adj);
+	}
+	data.shrink_to_fit();
+}
+
+CompressedGraph::CompressedGraph(istream& csr) : data(), base(), offset(), orbit(), n(0), m(0) {
+	/* Header and offsets, see write_csr. */
+	int64_t header[2];
+	csr.read(reinterpret_cast<char*>(header), sizeof(header));
+	if (!csr || header[0] < 0 || header[0] > INT32_MAX || header[1] < 0 || header[1] % 2 != 0
+			|| header[1] / 2 > INT32_MAX) {
+		throw runtime_error("Invalid CSR file");
+	}
+	n = int(header[0]);
+	m = int(header[1] / 2);
+	vector<int64_t> adj_offset(n + 1);
+	csr.read(reinterpret_cast<char*>(adj_offset.data()), adj_offset.size() * sizeof(int64_t));
+	if (!csr || adj_offset[0] != 0 || adj_offset[n] != header[1]) {
+		throw runtime_error("Invalid CSR file");
+	}
+
+	base.reserve(n / 64 + 1);
+	offset.reserve(n);
+	vector<Node> adj;
+	for (Node u = 0; u < n; ++u) {
+		int64_t degree = adj_offset[u + 1] - adj_offset[u];
+		if (degree < 0 || degree > header[1]) {
+			throw runtime_error("Invalid CSR file");
+		}
+		adj.resize(size_t(degree));
+		csr.read(reinterpret_cast<char*>(adj.data()), adj.size() * sizeof(int32_t));
+		if (!csr) {
+			throw runtime_error("Invalid CSR file");
+		}
+		for (Node v: adj) {
+			if (v < 0 || v >= n) {
+				throw runtime_error("Invalid CSR file");
+			}
+		}
+		append(u, adj);
+	}
+	data.shrink_to_fit();
+}
+
+void CompressedGraph::append(Node u, vector<Node>& adj) {
+	if (u % 64 == 0) {
+		base.push_back(data.size());
+	}
+	offset.push_back(uint32_t(data.size() - base.back()));
+	sort(begin(adj), end(adj));
+
+	encode(data, uint32_t(adj.size()));
+	for (size_t i = 0; i < adj.size(); ++i) {
+		if (i == 0) {
+			/* Zig-zag encoding of the signed difference. */
+			Node diff = adj[0] - u;
+			encode(data, (diff >= 0) ? uint32_t(diff) << 1 : (uint32_t(-diff - 1) << 1) | 1);
+		} else {
+			encode(data, uint32_t(adj[i] - adj[i - 1]));
+		}
+	}
+}
+
+const uint8_t* CompressedGraph::list(Node u) const {
+	return data.data() + base[u / 64] + offset[u];
+}
+
+int CompressedGraph::nnodes() const {
+	return n;
+}
+
+int CompressedGraph::nedges() const {
+	return m;
+}
+
+int CompressedGraph::degree(Node u) const {
+	const uint8_t* p = list(u);
+	uint32_t x = 0;
+	for (int shift = 0; ; shift += 7) {
+		x |= uint32_t(*p & 0x7f) << shift;
+		if (*p++ < 0x80) {
+			return int(x);
+		}
+	}
+}
+
+vector<Node> CompressedGraph::orbit_representatives() const {
+	vector<Node> reps;
+	set<int> seen;
+	for (Node u = 0; u < n; ++u) {
+		if (orbit.empty() || seen.insert(orbit[u]).second) {
+			reps.push_back(u);
+		}
+	}
+	return reps;
+}
+
+CompressedGraph::Range CompressedGraph::neighbours(Node u) const {
+	return Range{Iterator(list(u), u)};
+}
+
+size_t CompressedGraph::bytes() const {
+	return data.size() * sizeof(uint8_t) + base.size() * sizeof(uint64_t)
+	     + offset.size() * sizeof(uint32_t);
+}
+
+double CompressedGraph::bytes_per_edge() const {
+	return (m > 0) ? double(bytes()) / m : 0.0;
+}
@@ -0,0 +1,112 @@
+#ifndef _COMPRESSED_H
+#define _COMPRESSED_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <iostream>
+#include "graph.h"
+
+/**
+ * compressed.h: Read-only copy of a Graph with compressed adjacency lists.
+ *
+ * Each adjacency list is stored as its degree followed by the sorted
+ * neighbours, all as byte-aligned varints (7 bits per byte, high bit set on
+ * all but the last byte). The first neighbour v of u is stored as the
+ * zig-zag encoded difference v - u, all further ones as the gap to their
+ * predecessor. Node labels are not kept.
+ */
+class CompressedGraph {
+private:
+	/* Encoded adjacency lists. Node u starts at base[u / 64] + offset[u],
+	   so offsets only need 32 bits each. */
+	std::vector<uint8_t> data;
+	std::vector<uint64_t> base;
+	std::vector<uint32_t> offset;
+	std::vector<int> orbit;      /* Symmetry metadata of the Graph, if any. */
+	int n, m;                    /* #nodes & #edges */
+
+	/* Start of the list of u. */
+	const uint8_t* list(Node u) const;
+
+	/* Appends the list of the next node u; sorts adj. */
+	void append(Node u, std::vector<Node>& adj);
+
+public:
+	/* Decoding iterator over the neighbours of a node. */
+	class Iterator {
+	private:
+		const uint8_t* p;
+		int left;
+		Node cur;
+
+		static uint32_t decode(const uint8_t*& p) {
+			uint32_t x = *p++;
+			if (x >= 0x80) {
+				x &= 0x7f;
+				for (int shift = 7; ; shift += 7) {
+					uint32_t b = *p++;
+					x |= (b & 0x7f) << shift;
+					if (b < 0x80) {
+						break;
+					}
+				}
+			}
+			return x;
+		}
+
+	public:
+		/* Iterator at the first neighbour of u, given the start of u's list. */
+		Iterator(const uint8_t* list, Node u) : p(list), left(int(decode(p))), cur(u) {
+			if (left > 0) {
+				uint32_t z = decode(p);
+				cur = u + ((z & 1) ? -Node(z >> 1) - 1 : Node(z >> 1));
+			}
+		}
+		/* End iterator. */
+		Iterator() : p(nullptr), left(0), cur(0) {}
+
+		Node operator*() const { return cur; }
+		bool operator!=(const Iterator& other) const { return left != other.left; }
+		Iterator& operator++() {
+			if (--left > 0) {
+				cur += Node(decode(p));
+			}
+			return *this;
+		}
+	};
+
+	struct Range {
+		Iterator first;
+		Iterator begin() const { return first; }
+		Iterator end() const { return Iterator(); }
+	};
+
+	/* Compresses G in O(n + m log m) time; its symmetry metadata is kept. */
+	explicit CompressedGraph(const Graph& G);
+
+	/* Compresses a CSR file written by write_csr (see stream.h) list by list,
+	   without building a Graph: besides the result only the offsets are kept
+	   in memory. */
+	explicit CompressedGraph(std::istream& csr);
+
+	/* Getters. */
+	int nnodes() const;
+	int nedges() const;
+
+	/* Degree of u in O(1) time. */
+	int degree(Node u) const;
+
+	/* One node per orbit (all nodes without metadata), see Graph. */
+	std::vector<Node> orbit_representatives() const;
+
+	/* Neighbours of u in increasing order, e.g. for (Node v: C.neighbours(u)). */
+	Range neighbours(Node u) const;
+
+	/* Memory used by the adjacency lists including offsets, in total and per
+	   (undirected) edge. */
+	size_t bytes() const;
+	double bytes_per_edge() const;
+};
+
+#endif
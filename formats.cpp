@@ -0,0 +1,122 @@
+#include <climits>
+#include <cstdint>
+#include <stdexcept>
+#include "formats.h"
+
+using namespace std;
+
+static const string GRAPH6_HEADER = ">>graph6<<", SPARSE6_HEADER = ">>sparse6<<";
+
+/* Strips an optional header. */
+static size_t body_start(const string& line) {
+	if (line.compare(0, GRAPH6_HEADER.size(), GRAPH6_HEADER) == 0) {
+		return GRAPH6_HEADER.size();
+	} else if (line.compare(0, SPARSE6_HEADER.size(), SPARSE6_HEADER) == 0) {
+		return SPARSE6_HEADER.size();
+	}
+	return 0;
+}
+
+bool is_graph6(const string& line) {
+	size_t pos = body_start(line);
+	if (pos == line.size()) {
+		return false;
+	}
+	for (; pos < line.size(); ++pos) {
+		if (line[pos] < 58 || line[pos] > 126) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Reads the 6-bit groups of the line as a bit stream, high bits first. */
+class BitReader {
+private:
+	const string& line;
+	size_t pos;
+	int bit;
+
+public:
+	BitReader(const string& line, size_t pos) : line(line), pos(pos), bit(5) {}
+
+	/* Number of bits left. */
+	size_t left() const {
+		return (pos < line.size()) ? (line.size() - pos - 1) * 6 + bit + 1 : 0;
+	}
+
+	/* Next k bits as number (k <= 64); throws if fewer are left. */
+	uint64_t read(int k) {
+		if (size_t(k) > left()) {
+			throw runtime_error("Invalid graph6 line '" + line + "'");
+		}
+		uint64_t x = 0;
+		for (int i = 0; i < k; ++i) {
+			x = (x << 1) | (((line[pos] - 63) >> bit) & 1);
+			if (--bit < 0) {
+				bit = 5;
+				pos++;
+			}
+		}
+		return x;
+	}
+};
+
+void read_graph6(const string& line, Graph& G) {
+	size_t pos = body_start(line);
+	bool sparse = pos < line.size() && line[pos] == ':';
+	pos += sparse;
+
+	/* Number of nodes: 1, 4 or 8 bytes. */
+	if (pos >= line.size()) {
+		throw runtime_error("Invalid graph6 line '" + line + "'");
+	}
+	BitReader bits(line, pos);
+	uint64_t n = bits.read(6);
+	if (n == 63) {
+		n = bits.read(6);
+		n = (n == 63) ? bits.read(36) : (n << 12) | bits.read(12);
+	}
+
+	/* Validate the size before any node is added; graph6 has a bit for
+	   every node pair. */
+	if (n > uint64_t(INT_MAX) || (!sparse && bits.left() < n * (n - 1) / 2)) {
+		throw runtime_error("Invalid graph6 line '" + line + "'");
+	}
+	G.clear();
+	G.reserve_nodes(int(n));
+	for (Node u = 0; u < Node(n); ++u) {
+		G.add_node();
+	}
+
+	if (!sparse) {
+		/* Upper triangle of the adjacency matrix, column by column. */
+		for (Node v = 1; v < Node(n); ++v) {
+			for (Node u = 0; u < v; ++u) {
+				if (bits.read(1)) {
+					G.add_edge(u, v);
+				}
+			}
+		}
+	} else {
+		/* Edges as (b, x) pairs with x of k bits, see the nauty documentation. */
+		int k = 0;
+		while (k < 63 && (uint64_t(1) << k) < n) {
+			k++;
+		}
+		uint64_t v = 0;
+		while (bits.left() >= size_t(k + 1)) {
+			if (bits.read(1)) {
+				v++;
+			}
+			uint64_t x = bits.read(k);
+			if (v >= n) {
+				break;
+			} else if (x > v) {
+				v = x;
+			} else {
+				G.add_edge(Node(x), Node(v));
+			}
+		}
+	}
+}
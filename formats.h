@@ -0,0 +1,16 @@
+#ifndef _FORMATS_H
+#define _FORMATS_H
+
+#include <string>
+#include "graph.h"
+
+/** formats.h: Reading graphs in the graph6 and sparse6 formats of nauty. */
+
+/* Tests whether line is a graph6 or sparse6 line (optionally with header). */
+bool is_graph6(const std::string& line);
+
+/* Replaces G by the graph6 or sparse6 (leading ':') graph given by line,
+   reusing the memory of G. Nodes are labelled 1 to n. */
+void read_graph6(const std::string& line, Graph& G);
+
+#endif
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <sstream>
+#include <string>
 #include "graph.h"
 #include "special.h"
 
@@ -7,8 +8,18 @@ using namespace std;
 
 /** gen.cpp: Program for generating special graphs in TGF format. */
 int main(int argc, char** argv) {
-	if (argc <= 1) {
-		cerr << "Usage: " << argv[0] << " <name of graph>\n";
+	bool symmetry = false;
+	string name;
+	for (int i = 1; i < argc; ++i) {
+		string arg = argv[i];
+		if (arg == "--symmetry") {
+			symmetry = true;
+		} else {
+			name = arg;
+		}
+	}
+	if (name.empty()) {
+		cerr << "Usage: " << argv[0] << " [--symmetry] <name of graph>\n";
 		cerr << "Graphs:\n";
 		cerr << "  Qn:    hypercube\n";
 		cerr << "  KGn,k: Kneser graph\n";
@@ -17,43 +28,47 @@ int main(int argc, char** argv) {
 		cerr << "  En:    empty graph\n";
 		cerr << "  Pn:    path\n";
 		cerr << "  Cn:    cycle\n";
+		cerr << "--symmetry adds the orbits of the graph as '#transitive' or '#orbits ...'\n";
+		cerr << "line, which check uses but other TGF readers may reject.\n";
 		return 1;
 	}
 
-	istringstream in(argv[1]);
+	istringstream in(name);
 	char type, tmp;
+	Graph G;
 	in >> type;
 	if (type == 'Q') { /* hypercube */
 		int size;
 		in >> size;
-		cout << hypercube(size);
+		G = hypercube(size);
 	} else if (type == 'K') {
 		if (in.peek() == 'G') { /* kneser */
 			in.get();
 			int n, k;
 			in >> n >> tmp >> k;
-			cout << kneser(n, k);
+			G = kneser(n, k);
 		} else { /* complete or complete bipartite graph. */
 			int n, m;
 			in >> n;
 			if (in >> tmp >> m) {
-				cout << complete_bipartite(n, m);
+				G = complete_bipartite(n, m);
 			} else {
-				cout << complete_graph(n);
+				G = complete_graph(n);
 			}
 		}
 	} else if (type == 'E') { /* empty graph */
 		int n; in >> n;
-		cout << empty_graph(n);
+		G = empty_graph(n);
 	} else if (type == 'P') { /* path */
 		int n; in >> n;
-		cout << path(n);
+		G = path(n);
 	} else if (type == 'C') { /* cycle */
 		int n; in >> n;
-		cout << cycle(n);
+		G = cycle(n);
 	} else {
 		cerr << "Graph type '" << type << "' unknown\n";
 		return 1;
 	}
+	write_tgf(cout, G, symmetry);
 	return 0;
 }
@@ -1,3 +1,4 @@
+#include <set>
 #include <string>
 #include <cassert>
 #include <fstream>
@@ -8,12 +9,48 @@
 
 using namespace std;
 
+/* Chunks grow geometrically from MIN_CHUNK to MAX_CHUNK entries; larger
+   blocks get a chunk of their own. */
+static const size_t MIN_CHUNK = 1024, MAX_CHUNK = 1 << 16;
+
+/* Size class of a block with cap entries. */
+static int floor_log2(unsigned cap) {
+	int k = 0;
+	while (cap >>= 1) {
+		k++;
+	}
+	return k;
+}
+
+Graph::Graph(const Graph& other) : labels(other.labels), blocks(other.blocks),
+		chunks(), used(0), free_slots(), orbit(other.orbit), n(other.n), m(other.m) {
+	pack();
+}
+
+Graph& Graph::operator=(const Graph& other) {
+	if (this != &other) {
+		*this = Graph(other);
+	}
+	return *this;
+}
+
 Graph::Graph(istream& in) : Graph() {
 	/** Read nodes. */
 	string line;
+	vector<int> orbits;
+	bool transitive = false;
 	while (getline(in, line)) {
 		if (line == "#") {
 			break;
+		} else if (line == "#transitive") {
+			transitive = true;
+			continue;
+		} else if (line.compare(0, 7, "#orbits") == 0) {
+			istringstream ids(line.substr(7));
+			for (int id; ids >> id; ) {
+				orbits.push_back(id);
+			}
+			continue;
 		}
 
 		istringstream cur_line(line);
@@ -30,7 +67,7 @@ Graph::Graph(istream& in) : Graph() {
 		/* Now actually add the node. */
 		if (u > n) {
 			labels.resize(u);
-			adj.resize(u);
+			blocks.resize(u, Block{nullptr, 0, 0});
 			n = u;
 		}
 		labels[u - 1] = label;
@@ -45,6 +82,14 @@ Graph::Graph(istream& in) : Graph() {
 		getline(cur_line, label); /* Edge label unused. */
 		add_edge(u - 1, v - 1);
 	}
+
+	/* Symmetry metadata, only valid for the complete graph. */
+	if (transitive) {
+		set_vertex_transitive();
+	} else if (!orbits.empty()) {
+		set_orbits(orbits);
+	}
+	compact();
 }
 
 void Graph::check(Node u) const {
@@ -54,6 +99,202 @@ void Graph::check(Node u) const {
 	}
 }
 
+void Graph::add_chunk(size_t size) {
+	if (!chunks.empty()) {
+		release(chunks.back().data.get() + used, int(chunks.back().cap - used));
+	}
+	chunks.push_back(Chunk{unique_ptr<Node[]>(new Node[size]), size});
+	used = 0;
+}
+
+Node* Graph::allocate(int& cap) {
+	/* A released block of the smallest size class that surely fits. */
+	int k = floor_log2(cap);
+	if ((1 << k) < cap) {
+		k++;
+	}
+	if (k < int(free_slots.size()) && !free_slots[k].empty()) {
+		Node* data = free_slots[k].back();
+		free_slots[k].pop_back();
+		cap = 1 << k;
+		return data;
+	}
+
+	/* Otherwise room in the last chunk or a new, larger one. */
+	if (chunks.empty() || used + cap > chunks.back().cap) {
+		size_t size = chunks.empty() ? MIN_CHUNK : min(MAX_CHUNK, 2 * chunks.back().cap);
+		add_chunk(max(size, size_t(cap)));
+	}
+	Node* data = chunks.back().data.get() + used;
+	used += cap;
+	return data;
+}
+
+void Graph::release(Node* data, int cap) {
+	if (cap <= 0) {
+		return;
+	}
+	size_t k = floor_log2(cap);
+	if (k >= free_slots.size()) {
+		free_slots.resize(k + 1);
+	}
+	free_slots[k].push_back(data);
+}
+
+void Graph::grow(Node u, int cap) {
+	Block& b = blocks[u];
+	if (cap <= b.cap) {
+		return;
+	}
+
+	if (b.cap > 0 && used >= size_t(b.cap) && b.data == chunks.back().data.get() + used - b.cap
+			&& used + (cap - b.cap) <= chunks.back().cap) {
+		/* Last block in the last chunk: grow in place. */
+		used += cap - b.cap;
+	} else {
+		/* Otherwise move the block; smaller blocks can reuse its space. */
+		Node* data = allocate(cap);
+		copy(b.data, b.data + b.size, data);
+		release(b.data, b.cap);
+		b.data = data;
+	}
+	b.cap = cap;
+}
+
+void Graph::pack() {
+	size_t size = 0;
+	for (const Block& b: blocks) {
+		size += b.size;
+	}
+	chunks.clear();
+	free_slots.clear();
+	used = 0;
+	if (size > 0) {
+		add_chunk(size);
+	}
+	for (Block& b: blocks) {
+		Node* data = (b.size > 0) ? chunks.back().data.get() + used : nullptr;
+		copy(b.data, b.data + b.size, data);
+		used += b.size;
+		b = Block{data, b.size, b.size};
+	}
+}
+
+void Graph::compact() {
+	if (chunks.empty()) {
+		return;
+	}
+
+	/* Order the blocks by chunk and position within it. */
+	vector<pair<const Node*, size_t>> bases;
+	for (size_t i = 0; i < chunks.size(); ++i) {
+		bases.push_back({chunks[i].data.get(), i});
+	}
+	sort(begin(bases), end(bases), [] (const pair<const Node*, size_t>& x, const pair<const Node*, size_t>& y) {
+		return less<const Node*>()(x.first, y.first);
+	});
+	vector<pair<size_t, ptrdiff_t>> position(n, {0, 0});
+	for (Node u = 0; u < n; ++u) {
+		if (blocks[u].cap > 0) {
+			auto it = upper_bound(begin(bases), end(bases), blocks[u].data,
+					[] (const Node* p, const pair<const Node*, size_t>& base) {
+				return less<const Node*>()(p, base.first);
+			}) - 1;
+			position[u] = {it->second, blocks[u].data - it->first};
+		}
+	}
+	vector<Node> order(n);
+	for (Node u = 0; u < n; ++u) {
+		order[u] = u;
+	}
+	sort(begin(order), end(order), [&] (Node x, Node y) {
+		return position[x] < position[y];
+	});
+
+	/* Slide every block down to the first place it fits; it never passes
+	   a block that has not been moved yet. */
+	size_t chunk = 0, offset = 0;
+	for (Node u: order) {
+		Block& b = blocks[u];
+		if (b.size == 0) {
+			b = Block{nullptr, 0, 0};
+			continue;
+		}
+		while (offset + b.size > chunks[chunk].cap) {
+			chunk++;
+			offset = 0;
+		}
+		Node* data = chunks[chunk].data.get() + offset;
+		if (data != b.data) {
+			copy(b.data, b.data + b.size, data);
+		}
+		b = Block{data, b.size, b.size};
+		offset += b.size;
+	}
+	chunks.resize(chunk + 1);
+	used = offset;
+	free_slots.clear();
+}
+
+void Graph::reserve_nodes(int nnodes, int degree) {
+	labels.reserve(nnodes);
+	blocks.reserve(nnodes);
+	size_t size = size_t(nnodes) * max(degree, 0);
+	if (size > 0 && (chunks.empty() || chunks.back().cap - used < size)) {
+		add_chunk(size);
+	}
+}
+
+void Graph::reserve_degree(Node u, int degree) {
+	check(u);
+	grow(u, degree);
+}
+
+void Graph::clear() {
+	labels.clear();
+	blocks.clear();
+	if (!chunks.empty()) {
+		swap(chunks.front(), *max_element(begin(chunks), end(chunks), [] (const Chunk& x, const Chunk& y) {
+			return x.cap < y.cap;
+		}));
+		chunks.resize(1);
+	}
+	used = 0;
+	free_slots.clear();
+	orbit.clear();
+	n = m = 0;
+}
+
+void Graph::set_orbits(const vector<int>& orbits) {
+	if (!orbits.empty() && int(orbits.size()) != n) {
+		throw runtime_error("Orbits do not match the number of nodes");
+	}
+	orbit = orbits;
+}
+
+void Graph::set_vertex_transitive() {
+	orbit.assign(n, 0);
+}
+
+const vector<int>& Graph::orbits() const {
+	return orbit;
+}
+
+bool Graph::is_vertex_transitive() const {
+	return !orbit.empty() && count(begin(orbit), end(orbit), orbit[0]) == n;
+}
+
+vector<Node> Graph::orbit_representatives() const {
+	vector<Node> reps;
+	set<int> seen;
+	for (Node u = 0; u < n; ++u) {
+		if (orbit.empty() || seen.insert(orbit[u]).second) {
+			reps.push_back(u);
+		}
+	}
+	return reps;
+}
+
 Node Graph::add_node(const string& label) {
 	if (label != "") {
 		labels.push_back(label);
@@ -61,14 +302,22 @@ Node Graph::add_node(const string& label) {
 		ostringstream str; str << n+1;
 		labels.push_back(str.str());
 	}
-	adj.push_back({});
+	blocks.push_back(Block{nullptr, 0, 0});
+	orbit.clear();
 	return n++;
 }
 
 void Graph::add_edge(Node u, Node v) {
 	check(u), check(v);
-	adj[u].push_back(v);
-	adj[v].push_back(u);
+	auto append = [&] (Node a, Node b) {
+		if (blocks[a].size == blocks[a].cap) {
+			grow(a, max(4, 2 * blocks[a].cap));
+		}
+		blocks[a].data[blocks[a].size++] = b;
+	};
+	append(u, v);
+	append(v, u);
+	orbit.clear();
 	m++;
 }
 
@@ -82,7 +331,8 @@ int Graph::nnodes() const {
 }
 
 bool Graph::is_adjacent(Node u, Node v) const {
-	return find(begin(adj[u]), end(adj[u]), v) != end(adj[u]);
+	NodeRange adj = neighbours(u);
+	return find(adj.begin(), adj.end(), v) != adj.end();
 }
 
 int Graph::nedges() const {
@@ -90,21 +340,40 @@ int Graph::nedges() const {
 }
 
 int Graph::degree(Node u) const {
-	return int(adj[u].size());
+	return blocks[u].size;
 }
 
 void Graph::for_neighbours(Node u, const std::function<void(Node)>& f) const {
 	check(u);
-	for (Node v: adj[u]) {
+	for (Node v: neighbours(u)) {
 		f(v);
 	}
 }
 
+Graph::NodeRange Graph::neighbours(Node u) const {
+	const Node* first = blocks[u].data;
+	return NodeRange{first, first + blocks[u].size};
+}
+
 std::ostream& operator<<(std::ostream& os, const Graph& G) {
-	/* Simple TGF output. */
+	write_tgf(os, G, false);
+	return os;
+}
+
+void write_tgf(std::ostream& os, const Graph& G, bool symmetry) {
+	/* Simple TGF output, symmetry metadata as extra line before '#'. */
 	for (Node u = 0; u < G.nnodes(); ++u) {
 		os << u + 1 << " " << G.label(u) << "\n";
 	}
+	if (symmetry && G.is_vertex_transitive()) {
+		os << "#transitive\n";
+	} else if (symmetry && !G.orbits().empty()) {
+		os << "#orbits";
+		for (int id: G.orbits()) {
+			os << " " << id;
+		}
+		os << "\n";
+	}
 	os << "#\n";
 	for (Node u = 0; u < G.nnodes(); ++u) {
 		G.for_neighbours(u, [&] (Node v) {
@@ -113,14 +382,13 @@ std::ostream& operator<<(std::ostream& os, const Graph& G) {
 			}
 		});
 	}
-	return os;
 }
 
 vector<vector<int>> Graph::one_step_matrix() const {
 	vector<vector<int>> out(n, vector<int>(n, INF));
 	for (Node u = 0; u < n; ++u) {
 		out[u][u] = 0;
-		for (Node v: adj[u]) {
+		for (Node v: neighbours(u)) {
 			out[u][v] = 1;
 		}
 	}
@@ -130,7 +398,7 @@ vector<vector<int>> Graph::one_step_matrix() const {
 vector<pair<Node, Node>> Graph::edge_list() const {
 	vector<pair<Node, Node>> out;
 	for (Node u = 0; u < n; ++u) {
-		for (Node v: adj[u]) {
+		for (Node v: neighbours(u)) {
 			if (v > u) {
 				out.push_back({u, v});
 			}
@@ -140,8 +408,19 @@ vector<pair<Node, Node>> Graph::edge_list() const {
 }
 
 void Graph::remove_edge(Node u, Node v) {
-	adj[u].erase(remove(begin(adj[u]), end(adj[u]), v), end(adj[u]));
-	adj[v].erase(remove(begin(adj[v]), end(adj[v]), u), end(adj[v]));
+	/* Removes all (parallel) edges uv by compacting both blocks. */
+	auto erase = [&] (Node a, Node b) {
+		Node* first = blocks[a].data;
+		int removed = blocks[a].size - int(remove(first, first + blocks[a].size, b) - first);
+		blocks[a].size -= removed;
+		return removed;
+	};
+	orbit.clear();
+	int removed = erase(u, v);
+	m -= (u == v) ? removed / 2 : removed;
+	if (u != v) {
+		erase(v, u);
+	}
 }
 
 Graph Graph::line_graph() const {
@@ -151,7 +430,7 @@ Graph Graph::line_graph() const {
 	int line_nodes = 0;
 	vector<pair<Node, Node>> nodes; /* Remeber the pair of nodes that forms a new node. */
 	for (Node u = 0; u < n; ++u) {
-		for (Node v: adj[u]) {
+		for (Node v: neighbours(u)) {
 			if (v >= u) {
 				ostringstream label;
 				label << u << ", " << v;
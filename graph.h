@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 #include <functional>
 #include <climits>
 
@@ -12,27 +13,89 @@ const int INF = INT_MAX / 4;
 /**
  * Undirected multigraph with adjacency list representation.
  * You may assume that nodes are given ids from 0 to nnodes() - 1.
+ *
+ * The adjacency lists of all nodes are stored as blocks in a shared pool of
+ * chunks instead of one heap allocation per node. A full block grows in place
+ * if it is the last one in the pool and moves otherwise; its old space goes
+ * to a free list per size class (powers of two) for smaller blocks, so
+ * growing neither copies the pool nor leaves holes behind.
  */
 typedef int Node;
 typedef int Dist;
 class Graph {
 private:
+	/* Position of a node's adjacency list in the pool. */
+	struct Block {
+		Node* data;
+		int size, cap;
+	};
+
+	/* Memory of the pool, filled front to back. */
+	struct Chunk {
+		std::unique_ptr<Node[]> data;
+		size_t cap;
+	};
+
 	std::vector<std::string> labels;    /* Node labels. */
-	std::vector<std::vector<Node>> adj; /* Adjacency list. */
+	std::vector<Block> blocks;          /* Adjacency list of each node ... */
+	std::vector<Chunk> chunks;          /* ... stored in these chunks, */
+	size_t used;                        /* of which the last one is used up to here. */
+	std::vector<std::vector<Node*>> free_slots; /* Released blocks by size class. */
+	std::vector<int> orbit;             /* Symmetry metadata, see set_orbits(). */
 	int n, m;                           /* #nodes & #edges */
 
 	/** Checks whether the node id is valid. */
 	void check(Node u) const;
 
+	/** Makes room for at least cap neighbours of u. */
+	void grow(Node u, int cap);
+
+	/** Starts a new chunk of size entries; the rest of the last one is released. */
+	void add_chunk(size_t size);
+
+	/** Room for cap neighbours, from the free lists (which may round cap up)
+	    or the last chunk. */
+	Node* allocate(int& cap);
+
+	/** Hands cap entries at data to the free list of their size class. */
+	void release(Node* data, int cap);
+
+	/** Copies all blocks into one new chunk without spare room. */
+	void pack();
+
 public:
-	/* Default, copy & move construction. */
-	Graph() : labels(), adj(), n(0), m(0) {};
-	Graph(const Graph&) = default;
+	/* Range of neighbours, invalidated by any modification of the graph. */
+	struct NodeRange {
+		const Node *first, *last;
+		const Node* begin() const { return first; }
+		const Node* end() const { return last; }
+	};
+
+	/* Default, copy & move construction and assignment. Copies are compact. */
+	Graph() : labels(), blocks(), chunks(), used(0), free_slots(), orbit(), n(0), m(0) {};
+	Graph(const Graph& other);
 	Graph(Graph&&) = default;
+	Graph& operator=(const Graph& other);
+	Graph& operator=(Graph&&) = default;
 
-	/* Generates an undirected graph from a TGF file (little error checking!). */
+	/* Generates an undirected graph from a TGF file (little error checking!).
+	   Symmetry metadata is read from the optional lines '#transitive' or
+	   '#orbits o_1 ... o_n' before the '#' line. */
 	Graph(std::istream& in);
 
+	/* Capacity hints: room for nnodes nodes with (on average) degree neighbours
+	   each, or for degree neighbours of node u. */
+	void reserve_nodes(int nnodes, int degree = 0);
+	void reserve_degree(Node u, int degree);
+
+	/* Removes all nodes and edges but keeps the largest chunk of memory. */
+	void clear();
+
+	/* Moves the adjacency lists together in place, dropping their spare room
+	   and the free lists, in O(n log n + m) time. Call it once a graph is
+	   built. */
+	void compact();
+
 	/* Adds nodes or edges in O(1) amortised time. */
 	Node add_node(const std::string& label = "");
 	void add_edge(Node u, Node v);
@@ -54,6 +117,21 @@ public:
 	/* Calls f(v) for all neighbours v of u. */
 	void for_neighbours(Node u, const std::function<void(Node)>& f) const;
 
+	/* Neighbours of u as a contiguous range, e.g. for (Node v: G.neighbours(u)). */
+	NodeRange neighbours(Node u) const;
+
+	/* Symmetry metadata: an orbit id for every node such that nodes with the
+	   same id lie in the same orbit of the automorphism group (nodes with
+	   different ids may still be equivalent). Empty if unknown. It is not
+	   verified and cleared by any modification of the graph. */
+	void set_orbits(const std::vector<int>& orbits);
+	void set_vertex_transitive();
+	const std::vector<int>& orbits() const;
+	bool is_vertex_transitive() const;
+
+	/* One node per orbit, all nodes if no orbits are known. */
+	std::vector<Node> orbit_representatives() const;
+
 	/* Generates the distance matrix in one step, i.e. 0 from u to u,
 	   1 if u and v are adjacent, INF otherwise in O(n^2) time. */
 	std::vector<std::vector<int>> one_step_matrix() const;
@@ -65,7 +143,12 @@ public:
 	Graph line_graph() const;
 };
 
-/** Prints a graph in TGF format. */
+/** Prints a graph in plain TGF format. */
 std::ostream& operator<<(std::ostream& os, const Graph& G);
 
+/* TGF output that, with symmetry, also writes the metadata line
+   '#transitive' or '#orbits ...' read by Graph(std::istream&). Other TGF
+   readers may not accept it. */
+void write_tgf(std::ostream& os, const Graph& G, bool symmetry);
+
 #endif
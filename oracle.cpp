@@ -0,0 +1,84 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <chrono>
+#include <stdexcept>
+#include "graph.h"
+#include "pll.h"
+
+using namespace std;
+
+/** oracle.cpp: Program for building and querying a distance oracle. */
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		cerr << "Usage: " << argv[0] << " build index.pll [--threads=N] < graph.tgf\n";
+		cerr << "       " << argv[0] << " query index.pll [--threads=N] < pairs.txt\n";
+		cerr << "pairs.txt contains one pair of TGF node ids 'u v' per line.\n";
+		return 1;
+	}
+	string mode = argv[1], filename = argv[2];
+	int nthreads = 1;
+	for (int i = 3; i < argc; ++i) {
+		string arg = argv[i];
+		if (arg.compare(0, 10, "--threads=") == 0) {
+			nthreads = atoi(arg.c_str() + 10);
+		} else {
+			cerr << "Unknown option '" << arg << "'\n";
+			return 1;
+		}
+	}
+
+	if (mode == "build") {
+		ofstream out(filename, ios::binary);
+		if (!out) {
+			cerr << "Cannot write '" << filename << "'\n";
+			return 1;
+		}
+		Graph G(cin);
+		auto start = chrono::steady_clock::now();
+		DistanceOracle oracle(G, 16, nthreads);
+		chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+		oracle.save(out);
+		if (!out.flush()) {
+			cerr << "Cannot write '" << filename << "'\n";
+			return 1;
+		}
+		cerr << "Index for " << G.nnodes() << " nodes built in " << elapsed.count() << " s, "
+		     << oracle.average_label_size() << " label entries per node\n";
+	} else if (mode == "query") {
+		ifstream in(filename, ios::binary);
+		if (!in) {
+			cerr << "Cannot read '" << filename << "'\n";
+			return 1;
+		}
+		try {
+			DistanceOracle oracle(in);
+
+			/* Answer all queries as one batch. */
+			vector<pair<Node, Node>> pairs;
+			Node u, v;
+			while (cin >> u >> v) {
+				if (u <= 0 || u > oracle.nnodes() || v <= 0 || v > oracle.nnodes()) {
+					cerr << "Pair '" << u << " " << v << "' is invalid\n";
+					return 1;
+				}
+				pairs.push_back({u - 1, v - 1});
+			}
+			for (Dist d: oracle.query(pairs, nthreads)) {
+				if (d == INF) {
+					cout << "infinity\n";
+				} else {
+					cout << d << "\n";
+				}
+			}
+		} catch (const runtime_error& e) {
+			cerr << e.what() << "\n";
+			return 1;
+		}
+	} else {
+		cerr << "Mode '" << mode << "' unknown\n";
+		return 1;
+	}
+	return 0;
+}
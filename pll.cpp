@@ -0,0 +1,311 @@
+#include <atomic>
+#include <thread>
+#include <numeric>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+#include "pll.h"
+
+using namespace std;
+
+/* Binary I/O of plain values and vectors. */
+template <class T>
+static void write_raw(ostream& out, const T* data, size_t count) {
+	out.write(reinterpret_cast<const char*>(data), count * sizeof(T));
+}
+
+template <class T>
+static void read_raw(istream& in, T* data, size_t count) {
+	in.read(reinterpret_cast<char*>(data), count * sizeof(T));
+	if (!in) {
+		throw runtime_error("Invalid distance oracle file");
+	}
+}
+
+static const char MAGIC[4] = {'P', 'L', 'L', '1'};
+
+/* Bytes left in a seekable stream (SIZE_MAX if unknown), which bounds the
+   sizes read from an index before anything is allocated for them. */
+static size_t bytes_left(istream& in) {
+	streampos cur = in.tellg();
+	if (cur == streampos(-1)) {
+		return SIZE_MAX;
+	}
+	in.seekg(0, ios::end);
+	streampos end = in.tellg();
+	in.seekg(cur);
+	return (end >= cur) ? size_t(end - cur) : 0;
+}
+
+DistanceOracle::DistanceOracle(const Graph& G, int max_bp, int nthreads)
+	: n(G.nnodes()), nbp(0), bp(), offset(), hub(), dist() {
+	if (nthreads <= 0) {
+		nthreads = max(1u, thread::hardware_concurrency());
+	}
+
+	/* Landmark order: decreasing degree. */
+	vector<Node> order(n), rank(n);
+	iota(begin(order), end(order), 0);
+	stable_sort(begin(order), end(order), [&] (Node x, Node y) {
+		return G.degree(x) > G.degree(y);
+	});
+	for (int i = 0; i < n; ++i) {
+		rank[order[i]] = i;
+	}
+
+	/* Bit-parallel roots with up to 64 unused neighbours each, by rank. */
+	vector<bool> used(n, false);
+	vector<pair<Node, vector<Node>>> roots;
+	for (int i = 0; i < n && int(roots.size()) < max_bp; ++i) {
+		Node r = order[i];
+		if (used[r]) {
+			continue;
+		}
+		used[r] = true;
+		Graph::NodeRange range = G.neighbours(r);
+		vector<Node> adj(range.begin(), range.end()), S;
+		sort(begin(adj), end(adj), [&] (Node x, Node y) {
+			return rank[x] < rank[y];
+		});
+		for (Node v: adj) {
+			if (!used[v] && S.size() < 64) {
+				used[v] = true;
+				S.push_back(v);
+			}
+		}
+		roots.push_back({r, S});
+	}
+	nbp = int(roots.size());
+	bp.assign(size_t(n) * nbp, BPLabel{INF, 0, 0});
+
+	/* Bit-parallel BFS from each root: nodes inherit the sets of their
+	   parents (minus) and of their neighbours on the same level (zero). */
+	auto bp_bfs = [&] (int i) {
+		auto label = [&] (Node u) -> BPLabel& {
+			return bp[size_t(u) * nbp + i];
+		};
+		Node r = roots[i].first;
+		vector<Node> queue{r};
+		vector<pair<Node, Node>> sibling, child;
+		label(r).dist = 0;
+		for (size_t j = 0; j < roots[i].second.size(); ++j) {
+			Node s = roots[i].second[j];
+			label(s).dist = 1;
+			label(s).minus = uint64_t(1) << j;
+			queue.push_back(s);
+		}
+
+		for (size_t head = 0, tail = 1; head < queue.size(); head = tail, tail = queue.size()) {
+			sibling.clear(), child.clear();
+			for (size_t k = head; k < tail; ++k) {
+				Node v = queue[k];
+				Dist d = label(v).dist;
+				for (Node w: G.neighbours(v)) {
+					if (label(w).dist == d && v < w) {
+						sibling.push_back({v, w});
+					} else if (label(w).dist > d) {
+						if (label(w).dist == INF) {
+							label(w).dist = d + 1;
+							queue.push_back(w);
+						}
+						child.push_back({v, w});
+					}
+				}
+			}
+			for (auto e: sibling) {
+				label(e.first).zero |= label(e.second).minus;
+				label(e.second).zero |= label(e.first).minus;
+			}
+			for (auto e: child) {
+				label(e.second).minus |= label(e.first).minus;
+				label(e.second).zero |= label(e.first).zero;
+			}
+		}
+	};
+	atomic<int> next_root(0);
+	auto work = [&] () {
+		for (int i; (i = next_root++) < nbp; ) {
+			bp_bfs(i);
+		}
+	};
+	vector<thread> workers;
+	for (int t = 1; t < nthreads; ++t) {
+		workers.emplace_back(work);
+	}
+	work();
+	for (thread& w: workers) {
+		w.join();
+	}
+
+	/* Pruned BFS from all other landmarks in rank order. */
+	vector<vector<pair<Node, Dist>>> labels(n);
+	vector<Dist> root_label(n, INF), level(n, INF);
+	vector<Node> queue;
+	for (int i = 0; i < n; ++i) {
+		Node r = order[i];
+		if (used[r]) {
+			continue;
+		}
+		for (auto e: labels[r]) {
+			root_label[e.first] = e.second;
+		}
+
+		queue.assign(1, r);
+		level[r] = 0;
+		for (size_t head = 0; head < queue.size(); ++head) {
+			Node v = queue[head];
+			Dist d = level[v];
+			bool covered = bp_query(r, v) <= d;
+			for (size_t k = 0; k < labels[v].size() && !covered; ++k) {
+				covered = root_label[labels[v][k].first] + labels[v][k].second <= d;
+			}
+			if (covered) {
+				continue;
+			}
+
+			labels[v].push_back({i, d});
+			for (Node w: G.neighbours(v)) {
+				if (level[w] == INF) {
+					level[w] = d + 1;
+					queue.push_back(w);
+				}
+			}
+		}
+
+		for (Node v: queue) {
+			level[v] = INF;
+		}
+		for (auto e: labels[r]) {
+			root_label[e.first] = INF;
+		}
+	}
+
+	/* Flatten the labels. */
+	offset.assign(n + 1, 0);
+	for (Node u = 0; u < n; ++u) {
+		offset[u + 1] = offset[u] + labels[u].size();
+	}
+	hub.reserve(offset[n]);
+	dist.reserve(offset[n]);
+	for (Node u = 0; u < n; ++u) {
+		for (auto e: labels[u]) {
+			hub.push_back(e.first);
+			dist.push_back(e.second);
+		}
+		vector<pair<Node, Dist>>().swap(labels[u]);
+	}
+}
+
+DistanceOracle::DistanceOracle(istream& in) : n(0), nbp(0), bp(), offset(), hub(), dist() {
+	char magic[4];
+	int32_t header[2];
+	read_raw(in, magic, 4);
+	if (memcmp(magic, MAGIC, 4) != 0) {
+		throw runtime_error("Invalid distance oracle file");
+	}
+	read_raw(in, header, 2);
+	n = header[0], nbp = header[1];
+	if (n < 0 || nbp < 0 || nbp > n || size_t(n) * nbp > bytes_left(in) / sizeof(BPLabel)
+			|| size_t(n) + 1 > bytes_left(in) / sizeof(size_t)) {
+		throw runtime_error("Invalid distance oracle file");
+	}
+
+	bp.resize(size_t(n) * nbp);
+	offset.resize(n + 1);
+	read_raw(in, bp.data(), bp.size());
+	read_raw(in, offset.data(), offset.size());
+
+	/* Labels have at most n entries each. */
+	bool valid = offset[0] == 0;
+	for (Node u = 0; u < n && valid; ++u) {
+		valid = offset[u] <= offset[u + 1] && offset[u + 1] - offset[u] <= size_t(n);
+	}
+	if (!valid || offset[n] > bytes_left(in) / (sizeof(Node) + sizeof(Dist))) {
+		throw runtime_error("Invalid distance oracle file");
+	}
+	hub.resize(offset[n]);
+	dist.resize(offset[n]);
+	read_raw(in, hub.data(), hub.size());
+	read_raw(in, dist.data(), dist.size());
+}
+
+void DistanceOracle::save(ostream& out) const {
+	int32_t header[2] = {n, nbp};
+	write_raw(out, MAGIC, 4);
+	write_raw(out, header, 2);
+	write_raw(out, bp.data(), bp.size());
+	write_raw(out, offset.data(), offset.size());
+	write_raw(out, hub.data(), hub.size());
+	write_raw(out, dist.data(), dist.size());
+}
+
+Dist DistanceOracle::bp_query(Node u, Node v) const {
+	Dist best = INF;
+	const BPLabel* a = bp.data() + size_t(u) * nbp;
+	const BPLabel* b = bp.data() + size_t(v) * nbp;
+	for (int i = 0; i < nbp; ++i) {
+		if (a[i].dist == INF || b[i].dist == INF) {
+			continue;
+		}
+		Dist d = a[i].dist + b[i].dist;
+		if (d - 2 <= best) {
+			if (a[i].minus & b[i].minus) {
+				d -= 2;
+			} else if ((a[i].minus & b[i].zero) | (a[i].zero & b[i].minus)) {
+				d -= 1;
+			}
+			best = min(best, d);
+		}
+	}
+	return best;
+}
+
+Dist DistanceOracle::query(Node u, Node v) const {
+	if (u == v) {
+		return 0;
+	}
+
+	/* Merge the sorted labels. */
+	Dist best = bp_query(u, v);
+	size_t i = offset[u], j = offset[v];
+	while (i < offset[u + 1] && j < offset[v + 1]) {
+		if (hub[i] == hub[j]) {
+			best = min(best, dist[i++] + dist[j++]);
+		} else if (hub[i] < hub[j]) {
+			i++;
+		} else {
+			j++;
+		}
+	}
+	return best;
+}
+
+vector<Dist> DistanceOracle::query(const vector<pair<Node, Node>>& pairs, int nthreads) const {
+	if (nthreads <= 0) {
+		nthreads = max(1u, thread::hardware_concurrency());
+	}
+	vector<Dist> out(pairs.size());
+	auto work = [&] (int t) {
+		size_t first = pairs.size() * t / nthreads, last = pairs.size() * (t + 1) / nthreads;
+		for (size_t i = first; i < last; ++i) {
+			out[i] = query(pairs[i].first, pairs[i].second);
+		}
+	};
+	vector<thread> workers;
+	for (int t = 1; t < nthreads; ++t) {
+		workers.emplace_back(work, t);
+	}
+	work(0);
+	for (thread& w: workers) {
+		w.join();
+	}
+	return out;
+}
+
+int DistanceOracle::nnodes() const {
+	return n;
+}
+
+double DistanceOracle::average_label_size() const {
+	return (n > 0) ? double(hub.size()) / n : 0.0;
+}
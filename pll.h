@@ -0,0 +1,60 @@
+#ifndef _PLL_H
+#define _PLL_H
+
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include "graph.h"
+
+/**
+ * pll.h: Exact distance oracle by pruned landmark labelling
+ * (Akiba, Iwata, Yoshida 2013).
+ *
+ * Every node u gets a label of (landmark, d(landmark, u)) pairs such that
+ * each shortest u-v path contains a landmark of both labels. Landmarks are
+ * processed by decreasing degree and a BFS from a landmark is pruned at nodes
+ * whose distance is already covered by earlier labels. The first landmarks are
+ * handled bit-parallel: one BFS covers a root and up to 64 of its neighbours.
+ * A query merges two sorted labels, usually in microseconds.
+ */
+class DistanceOracle {
+private:
+	/* Bit-parallel label for one root r and its selected neighbours S:
+	   d(r, u) and the sets of s in S with d(s, u) = d(r, u) - 1 or d(r, u). */
+	struct BPLabel {
+		Dist dist;
+		uint64_t minus, zero;
+	};
+
+	int n, nbp;
+	std::vector<BPLabel> bp;       /* Bit-parallel labels of u: bp[u * nbp + i] */
+	std::vector<size_t> offset;    /* Label of u: hub[offset[u] .. offset[u + 1]) */
+	std::vector<Node> hub;         /* Rank of the landmark (increasing) ... */
+	std::vector<Dist> dist;        /* ... and distance to it. */
+
+	/* Distance bound from the bit-parallel labels. */
+	Dist bp_query(Node u, Node v) const;
+
+public:
+	/* Builds the index with up to nbp bit-parallel roots; their BFS runs use
+	   nthreads threads (<= 0: one per core). */
+	explicit DistanceOracle(const Graph& G, int nbp = 16, int nthreads = 1);
+
+	/* Reads an index written by save(). */
+	explicit DistanceOracle(std::istream& in);
+
+	/* Writes the index in a binary format. */
+	void save(std::ostream& out) const;
+
+	/* Exact distance between u and v (INF if disconnected). */
+	Dist query(Node u, Node v) const;
+
+	/* Distances for all pairs, computed on nthreads threads (<= 0: one per core). */
+	std::vector<Dist> query(const std::vector<std::pair<Node, Node>>& pairs, int nthreads = 1) const;
+
+	/* Number of nodes and average number of (non bit-parallel) label entries. */
+	int nnodes() const;
+	double average_label_size() const;
+};
+
+#endif
@@ -0,0 +1,44 @@
+#include <algorithm>
+#include "pool.h"
+
+using namespace std;
+
+ThreadPool::ThreadPool(int nthreads) : workers(), tasks(), mutex(), ready(), stop(false) {
+	if (nthreads <= 0) {
+		nthreads = max(1u, thread::hardware_concurrency());
+	}
+	for (int t = 0; t < nthreads; ++t) {
+		workers.emplace_back(&ThreadPool::work, this);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		lock_guard<std::mutex> lock(mutex);
+		stop = true;
+	}
+	ready.notify_all();
+	for (thread& w: workers) {
+		w.join();
+	}
+}
+
+int ThreadPool::size() const {
+	return int(workers.size());
+}
+
+void ThreadPool::work() {
+	for (;;) {
+		function<void()> task;
+		{
+			unique_lock<std::mutex> lock(mutex);
+			ready.wait(lock, [&] { return stop || !tasks.empty(); });
+			if (tasks.empty()) {
+				return;
+			}
+			task = move(tasks.front());
+			tasks.pop();
+		}
+		task();
+	}
+}
@@ -0,0 +1,49 @@
+#ifndef _POOL_H
+#define _POOL_H
+
+#include <queue>
+#include <mutex>
+#include <thread>
+#include <future>
+#include <memory>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+/** pool.h: Fixed-size thread pool for independent tasks. */
+class ThreadPool {
+private:
+	std::vector<std::thread> workers;
+	std::queue<std::function<void()>> tasks;
+	std::mutex mutex;
+	std::condition_variable ready;
+	bool stop;
+
+	/* Worker loop: run tasks until the pool is destroyed. */
+	void work();
+
+public:
+	/* Starts nthreads workers (<= 0: one per core). */
+	explicit ThreadPool(int nthreads = 0);
+
+	/* Finishes all submitted tasks and joins the workers. */
+	~ThreadPool();
+
+	/* Number of workers. */
+	int size() const;
+
+	/* Runs f() on a worker; the future yields its result or exception. */
+	template <class F>
+	std::future<typename std::result_of<F()>::type> submit(F f) {
+		typedef typename std::result_of<F()>::type Result;
+		auto task = std::make_shared<std::packaged_task<Result()>>(f);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			tasks.push([task] () { (*task)(); });
+		}
+		ready.notify_one();
+		return task->get_future();
+	}
+};
+
+#endif
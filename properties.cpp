@@ -1,6 +1,9 @@
 #include <iostream>
 #include <stdexcept>
 #include <algorithm>
+#include <numeric>
+#include <random>
+#include <chrono>
 #include "graph.h"
 #include "properties.h"
 #include "bfs.h"
@@ -11,7 +14,8 @@ using namespace std;
    pos: current node, visited: nodes already visited,
    memo: memoization array. */
 static bool hamiltonian_rec(const Graph& G, Node pos, int visited,
-	                        vector<vector<bool>>& memo, vector<Node>& path) {
+	                        vector<vector<bool>>& memo, vector<Node>& path, Ticker& ticker) {
+	ticker.check();
 	if (memo[pos][visited]) {
 		return false;
 	} else {
@@ -27,7 +31,7 @@ static bool hamiltonian_rec(const Graph& G, Node pos, int visited,
 		bool found = false;
 		G.for_neighbours(pos, [&] (Node next) {
 			if (!found && !(visited & (1 << next))) {
-				if (hamiltonian_rec(G, next, visited | (1 << next), memo, path)) {
+				if (hamiltonian_rec(G, next, visited | (1 << next), memo, path, ticker)) {
 					found = true;
 				}
 			}
@@ -41,14 +45,15 @@ static bool hamiltonian_rec(const Graph& G, Node pos, int visited,
 }
 
 /** Simple backtracking (or DP, if you want) search for Hamiltonian tour. */
-pair<bool, vector<Node>> hamiltonian_tour(const Graph& G) {
+pair<bool, vector<Node>> hamiltonian_tour(const Graph& G, const Budget& budget) {
 	if (G.nnodes() == 0 || G.nnodes() > 32) {
 		throw runtime_error("Graph too large or trivial");
 	}
 
 	vector<Node> path;
 	vector<vector<bool>> memo(G.nnodes(), vector<bool>(1 << G.nnodes(), false));
-	bool found = hamiltonian_rec(G, 0, 1, memo, path);
+	Ticker ticker(budget);
+	bool found = hamiltonian_rec(G, 0, 1, memo, path, ticker);
 	return {found, path};
 }
 
@@ -68,38 +73,221 @@ vector<vector<int>> apd(const Graph& G) {
 }
 
 /** Eccentricity */
-Dist eccentricity(const Graph& G, Node u) {
-	vector<Dist> dist(G.nnodes(), INF);
-	bfs(G, u, [&] (Node v, Dist d) {
-		dist[v] = d;
-	});
-	return *max_element(begin(dist), end(dist));
+template <class GraphT>
+static Dist eccentricity_impl(const GraphT& G, Node u, int nthreads) {
+	int reached = 0;
+	Dist ecc = 0;
+	bfs(G, u, [&] (Node, Dist d) {
+		reached++;
+		ecc = max(ecc, d);
+	}, nthreads);
+	return (reached < G.nnodes()) ? INF : ecc;
+}
+
+Dist eccentricity(const Graph& G, Node u, int nthreads) {
+	return eccentricity_impl(G, u, nthreads);
+}
+
+Dist eccentricity(const CompressedGraph& G, Node u, int nthreads) {
+	return eccentricity_impl(G, u, nthreads);
 }
 
 /** Diameter calculation using BFS. */
-int diam(const Graph& G) {
+template <class GraphT>
+static int diam_impl(const GraphT& G, const vector<Node>& sources, int nthreads) {
 	int max_dist = 0;
-	for (Node u = 0; u < G.nnodes(); ++u) {
-		max_dist = max(max_dist, eccentricity(G, u));
+	for (Node u: sources) {
+		max_dist = max(max_dist, eccentricity(G, u, nthreads));
 	}
 	return max_dist;
 }
 
-/** Girth of the graph: Remove every edge uv and then
-    determine the distance between u and v. */
-int girth(const Graph& G) {
-	Graph G2 = G;
-	auto edge_list = G.edge_list();
+/* Nodes in the same orbit have the same eccentricity. */
+int diam(const Graph& G, int nthreads) {
+	return diam_impl(G, G.orbit_representatives(), nthreads);
+}
+
+int diam(const CompressedGraph& G, int nthreads) {
+	return diam_impl(G, G.orbit_representatives(), nthreads);
+}
+
+/* BFS from u that stores the distances and returns ecc(u). */
+static Dist sweep(const Graph& G, Node u, vector<Dist>& dist, int nthreads, Ticker& ticker) {
+	fill(begin(dist), end(dist), INF);
+	bfs(G, u, [&] (Node v, Dist d) {
+		ticker.check();
+		dist[v] = d;
+	}, nthreads);
+	return *max_element(begin(dist), end(dist));
+}
+
+/* Middle node of a shortest path from b back to the source of dist. */
+static Node middle(const Graph& G, const vector<Dist>& dist, Node b) {
+	Dist target = dist[b] / 2;
+	while (dist[b] > target) {
+		for (Node w: G.neighbours(b)) {
+			if (dist[w] == dist[b] - 1) {
+				b = w;
+				break;
+			}
+		}
+	}
+	return b;
+}
+
+/** Diameter bounds using 4-sweep (Crescenzi et al.) and sampled sources. */
+DiamBounds approx_diam(const Graph& G, int samples, double seconds, int nthreads, const Budget& budget) {
+	int n = G.nnodes();
+	DiamBounds b{0, 0, 0, {}};
+	if (n == 0) {
+		return b;
+	}
+	auto start = chrono::steady_clock::now();
+	vector<Dist> dist(n);
+	Ticker ticker(budget);
+	auto run = [&] (Node u) {
+		Dist ecc = sweep(G, u, dist, nthreads, ticker);
+		b.nbfs++;
+		b.lower = max(b.lower, ecc);
+		b.upper = min(b.upper, (ecc == INF) ? INF : 2 * ecc);
+		return ecc;
+	};
+	auto farthest = [&] () {
+		return Node(max_element(begin(dist), end(dist)) - begin(dist));
+	};
+
+	/* 4-sweep: r1 -> a1 (farthest from r1), r2 = middle of a1 and the node
+	   farthest from it, r2 -> a2. Stops early if G is disconnected. */
+	b.upper = INF;
+	try {
+		if (run(maximum_degree(G)) != INF) {
+			run(farthest());
+			run(middle(G, dist, farthest()));
+			run(farthest());
+		}
+
+		/* Random sources (one per orbit) until the seconds are used up. */
+		vector<Node> order = G.orbit_representatives();
+		shuffle(begin(order), end(order), mt19937(42));
+		for (size_t i = 0; i < order.size() && b.lower < b.upper; ++i) {
+			chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+			if (int(i) >= samples && elapsed.count() >= seconds) {
+				break;
+			}
+			b.sampled.push_back(run(order[i]));
+			if (i == order.size() - 1) {
+				b.upper = b.lower; /* Every orbit had a source: exact. */
+			}
+		}
+	} catch (Timeout&) {
+		/* The bounds of the BFS runs completed so far. */
+	}
+	return b;
+}
+
+/* Diameter with budget over the orbit representatives; bfs_from(u, f) runs
+   one BFS from u. Every eccentricity computed so far is a lower bound and
+   its double an upper bound. The budget is checked during each BFS. */
+template <class GraphT, class BFSFrom>
+static Bounds diam_bounds(const GraphT& G, const Budget& budget, BFSFrom bfs_from) {
+	Bounds b{0, (G.nnodes() > 0) ? INF : 0};
+	Ticker ticker(budget);
+	try {
+		for (Node u: G.orbit_representatives()) {
+			int reached = 0;
+			Dist ecc = 0;
+			bfs_from(u, [&] (Node, Dist d) {
+				ticker.check();
+				reached++;
+				ecc = max(ecc, d);
+			});
+			if (reached < G.nnodes()) {
+				return {INF, INF};
+			}
+			b.lower = max(b.lower, ecc);
+			b.upper = min(b.upper, 2 * ecc);
+		}
+	} catch (Timeout&) {
+		return b;
+	}
+	return {b.lower, b.lower};
+}
+
+Bounds diam(const Graph& G, const Budget& budget, int nthreads) {
+	return diam_bounds(G, budget, [&] (Node u, const BFSFunc& f) {
+		bfs(G, u, f, nthreads);
+	});
+}
+
+Bounds diam(const CompressedGraph& G, const Budget& budget, int nthreads) {
+	return diam_bounds(G, budget, [&] (Node u, const BFSFunc& f) {
+		bfs(G, u, f, nthreads);
+	});
+}
 
+Bounds diam(const Graph& G, const Budget& budget, BFSScratch& scratch) {
+	return diam_bounds(G, budget, [&] (Node u, const BFSFunc& f) {
+		bfs(G, u, f, scratch);
+	});
+}
+
+/* Length of a shortest closed walk through u that contains a cycle: BFS
+   from u, closed by a non-tree edge ab as u -> a -> b -> u. It is at least
+   the girth and equal to it if u lies on a shortest cycle. Loops and edges
+   parallel to tree edges are not cycles. dist must be INF everywhere and
+   is restored. */
+static Dist cycle_through(const Graph& G, Node u, BFSScratch& scratch, Ticker& ticker) {
+	vector<Dist>& dist = scratch.dist;
+	vector<Node>& parent = scratch.parent;
+	vector<Node>& visit = scratch.queue;
+	Dist best = INF;
+	visit.assign(1, u);
+	dist[u] = 0;
+	parent[u] = -1;
+	for (size_t head = 0; head < visit.size() && 2 * dist[visit[head]] < best; ++head) {
+		Node a = visit[head];
+		ticker.check();
+		for (Node b: G.neighbours(a)) {
+			if (dist[b] == INF) {
+				dist[b] = dist[a] + 1;
+				parent[b] = a;
+				visit.push_back(b);
+			} else if (b != a && b != parent[a] && parent[b] != a) {
+				best = min(best, dist[a] + dist[b] + 1);
+			}
+		}
+	}
+	for (Node v: visit) {
+		dist[v] = INF;
+	}
+	return best;
+}
+
+/** Girth of the graph: the shortest cycle through any node, or through one
+    node per orbit if orbits are known. O(n(n + m)) time. */
+Bounds girth(const Graph& G, const Budget& budget, BFSScratch& scratch) {
 	int girth = INF;
-	for (auto edge: edge_list) {
-		Node u = edge.first, v = edge.second;
-		G2.remove_edge(u, v);
-		girth = min(girth, distance(G2, u, v));
-		G2.add_edge(u, v);
+	Ticker ticker(budget);
+	scratch.dist.assign(G.nnodes(), INF);
+	scratch.parent.resize(G.nnodes());
+	try {
+		for (Node u: G.orbit_representatives()) {
+			girth = min(girth, cycle_through(G, u, scratch, ticker));
+		}
+	} catch (Timeout&) {
+		/* Loops and parallel edges are not considered as cycles. */
+		return {min(girth, 3), girth};
 	}
+	return {girth, girth};
+}
 
-	return girth + 1;
+Bounds girth(const Graph& G, const Budget& budget) {
+	BFSScratch scratch;
+	return girth(G, budget, scratch);
+}
+
+int girth(const Graph& G) {
+	return girth(G, Budget()).upper;
 }
 
 /** Max. degree. */
@@ -115,41 +303,124 @@ Node maximum_degree(const Graph& G) {
 	return max_node;
 }
 
-/* Try to color the graph using ncolours possible colours. */
-bool try_colouring(const Graph& G, int ncolours, Node cur, vector<int>& colouring) {
-	if (cur >= G.nnodes()) {
-		return true;
+/* Try to color the graph using ncolours possible colours: backtracking over
+   the nodes in id order. Iterative, as the search is as deep as G is large;
+   colouring[u] is the colour u currently tries (0: none yet). */
+static bool try_colouring(const Graph& G, int ncolours, vector<int>& colouring, Ticker& ticker) {
+	Node cur = 0;
+	while (cur >= 0) {
+		if (cur >= G.nnodes()) {
+			return true;
+		}
+		ticker.check();
+
+		/* Next colour for cur that no earlier neighbour has. */
+		int colour = colouring[cur] + 1;
+		for (; colour <= ncolours; ++colour) {
+			bool available = true;
+			for (Node v: G.neighbours(cur)) {
+				if (v < cur && colouring[v] == colour) {
+					available = false;
+					break;
+				}
+			}
+			if (available) {
+				break;
+			}
+		}
+
+		/* Descend, or backtrack once all colours were tried. */
+		if (colour <= ncolours) {
+			colouring[cur++] = colour;
+		} else {
+			colouring[cur--] = 0;
+		}
 	}
+	return false;
+}
 
-	/* What colours are still available for cur? */
-	vector<bool> available(ncolours + 1, true);
-	G.for_neighbours(cur, [&] (Node v) {
-		available[colouring[v]] = false;
+/* Number of colours used by greedy colouring in order of decreasing degree. */
+static int greedy_colouring(const Graph& G) {
+	vector<Node> order(G.nnodes());
+	iota(begin(order), end(order), 0);
+	stable_sort(begin(order), end(order), [&] (Node x, Node y) {
+		return G.degree(x) > G.degree(y);
 	});
 
-	/* Recurse. */
-	for (int colour = 1; colour <= ncolours; ++colour) {
-		colouring[cur] = colour;
-		if (available[colour] && try_colouring(G, ncolours, cur + 1, colouring)) {
-			return true;
+	vector<int> colouring(G.nnodes(), 0);
+	vector<bool> used;
+	int ncolours = 0;
+	for (Node u: order) {
+		used.assign(G.degree(u) + 2, false);
+		for (Node v: G.neighbours(u)) {
+			if (colouring[v] <= G.degree(u)) {
+				used[colouring[v]] = true;
+			}
 		}
-		colouring[cur] = 0;
+		colouring[u] = int(find(begin(used) + 1, end(used), false) - begin(used));
+		ncolours = max(ncolours, colouring[u]);
 	}
-	return false;
+	return ncolours;
 }
 
-int chromatic_number(const Graph& G) {
-	for (int ncolours = 1; ncolours <= G.nnodes(); ++ncolours) {
-		vector<int> colouring(G.nnodes(), 0);
-		if (try_colouring(G, ncolours, 0, colouring)) {
-			return ncolours;
+/* Smallest number of colours in [lower, upper) that works, upper otherwise. */
+static Bounds colour_search(const Graph& G, int lower, int upper, const Budget& budget) {
+	Ticker ticker(budget);
+	try {
+		for (; lower < upper; ++lower) {
+			vector<int> colouring(G.nnodes(), 0);
+			if (try_colouring(G, lower, colouring, ticker)) {
+				return {lower, lower};
+			}
 		}
+	} catch (Timeout&) {
+		return {lower, upper};
+	}
+	return {upper, upper};
+}
+
+Bounds chromatic_number(const Graph& G, const Budget& budget) {
+	return colour_search(G, min(1, G.nnodes()), greedy_colouring(G), budget);
+}
+
+int chromatic_number(const Graph& G) {
+	return chromatic_number(G, Budget()).upper;
+}
+
+/* Larger graphs only get the bounds on the chromatic index. */
+static const int MAX_LINE_GRAPH_EDGES = 10000;
+
+Bounds chromatic_index(const Graph& G, const Budget& budget) {
+	if (G.nedges() == 0) {
+		return {0, 0};
+	}
+
+	/* Without loops, the edges at a node of max. degree form a clique in
+	   the line graph. For simple graphs Vizing's theorem gives Delta + 1. */
+	bool loops = false, parallel = false;
+	vector<Node> adj;
+	for (Node u = 0; u < G.nnodes(); ++u) {
+		Graph::NodeRange range = G.neighbours(u);
+		adj.assign(range.begin(), range.end());
+		sort(begin(adj), end(adj));
+		loops = loops || binary_search(begin(adj), end(adj), u);
+		parallel = parallel || adjacent_find(begin(adj), end(adj)) != end(adj);
+	}
+	int delta = G.degree(maximum_degree(G));
+	int lower = loops ? 1 : delta;
+	int upper = (loops || parallel) ? G.nedges() : delta + 1;
+	if (lower == upper) {
+		return {lower, upper};
+	}
+
+	/* The line graph takes O(m^2) time to build. */
+	if (budget.expired() || G.nedges() > MAX_LINE_GRAPH_EDGES) {
+		return {lower, upper};
 	}
-	return -1;
+	Graph L = G.line_graph();
+	return colour_search(L, lower, min(upper, greedy_colouring(L)), budget);
 }
 
 int chromatic_index(const Graph& G) {
-	/* Possible optimisation: test only whether edge colouring
-	   with \Delta(G) colours is possible and apply Vizing. */
-	return chromatic_number(G.line_graph());
+	return chromatic_index(G, Budget()).upper;
 }
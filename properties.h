@@ -2,23 +2,48 @@
 #define _PROPS_H
 
 #include "graph.h"
+#include "compressed.h"
+#include "bfs.h"
+#include "budget.h"
 
 /** Tests for some simple graph properties. */
 
 /** Simple backtracking test for Hamiltonicity. Only works for <= 32 nodes.
-    (Too slow for about 18 nodes.) Needs O(n*2^n) time (NP-complete). */
-std::pair<bool, std::vector<Node>> hamiltonian_tour(const Graph& G);
+    (Too slow for about 18 nodes.) Needs O(n*2^n) time (NP-complete).
+    Throws Timeout when the budget is used up. */
+std::pair<bool, std::vector<Node>> hamiltonian_tour(const Graph& G, const Budget& budget = Budget());
 
 /** All-pairs-shortest distance in O(n^3) time. */
 std::vector<std::vector<int>> apd(const Graph& G);
 
-/* Computes the eccentricity of u in G in O(n + m) time. */
-int ecc(const Graph& G, Node u);
+/* Computes the eccentricity of u in G in O(n + m) time
+   (BFS on nthreads threads, see bfs()). */
+int eccentricity(const Graph& G, Node u, int nthreads = 1);
+int eccentricity(const CompressedGraph& G, Node u, int nthreads = 1);
 
-/* Computes the diameter in O(n*(n + m))) time. */
-int diam(const Graph& G);
+/* Computes the diameter in O(n*(n + m))) time, or in O(#orbits*(n + m)) time
+   if G carries symmetry metadata (see Graph::set_orbits). */
+int diam(const Graph& G, int nthreads = 1);
+int diam(const CompressedGraph& G, int nthreads = 1);
 
-/* Computes the girth in O(m*(m + n)) time. */
+/**
+ * Bounds lower <= diam(G) <= upper from few BFS runs in O(n + m) time each:
+ * a 4-sweep gives the lower bound, every source s gives diam(G) <= 2 ecc(s).
+ * Afterwards at least samples random sources are used and more are added
+ * until the bounds meet, all nodes were used or the given seconds have
+ * passed. Once budget is used up, the bounds of the BFS runs so far are
+ * returned.
+ */
+struct DiamBounds {
+	Dist lower, upper;
+	int nbfs;                   /* #BFS runs */
+	std::vector<Dist> sampled;  /* Eccentricities of the random sources. */
+};
+DiamBounds approx_diam(const Graph& G, int samples = 16, double seconds = 0, int nthreads = 1,
+                       const Budget& budget = Budget());
+
+/* Computes the girth in O(n*(m + n)) time, or in O(#orbits*(n + m)) time
+   with symmetry metadata. */
 int girth(const Graph& G);
 
 /* Computes the node with max. degree in O(n) time. */
@@ -30,4 +55,25 @@ int chromatic_number(const Graph& G);
 /* Computes the chromatic index c' in O(c'^n) time (output-sensitive, NP-complete). */
 int chromatic_index(const Graph& G);
 
+/* Lower and upper bound of a graph invariant, exact if lower == upper. */
+struct Bounds {
+	int lower, upper;
+};
+
+/* Versions of the functions above that stop cooperatively when the budget is
+   used up and then return the best bounds found so far. diam and girth check
+   the budget during their BFS runs, the colourings start from a greedy upper
+   bound (chromatic_index: Vizing for simple graphs). chromatic_index only
+   returns these bounds for more than 10000 edges, as its line graph takes
+   O(m^2) time to build. */
+Bounds diam(const Graph& G, const Budget& budget, int nthreads = 1);
+Bounds diam(const CompressedGraph& G, const Budget& budget, int nthreads = 1);
+Bounds girth(const Graph& G, const Budget& budget);
+Bounds chromatic_number(const Graph& G, const Budget& budget);
+Bounds chromatic_index(const Graph& G, const Budget& budget);
+
+/* Sequential versions that reuse the buffers in scratch. */
+Bounds diam(const Graph& G, const Budget& budget, BFSScratch& scratch);
+Bounds girth(const Graph& G, const Budget& budget, BFSScratch& scratch);
+
 #endif
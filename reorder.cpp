@@ -0,0 +1,257 @@
+#include <cmath>
+#include <queue>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+#include "reorder.h"
+
+using namespace std;
+
+Order parse_order(const string& name) {
+	if (name == "none") {
+		return Order::NONE;
+	} else if (name == "bfs") {
+		return Order::BFS;
+	} else if (name == "rcm") {
+		return Order::RCM;
+	} else if (name == "degree") {
+		return Order::DEGREE;
+	} else if (name == "gorder") {
+		return Order::GORDER;
+	} else if (name == "auto") {
+		return Order::AUTO;
+	}
+	ostringstream error; error << "Node order '" << name << "' unknown";
+	throw runtime_error(error.str());
+}
+
+/* BFS from s that appends the visited nodes to out and sets their level.
+   Visited nodes are marked with id, nodes with another mark count as
+   unvisited. If by_degree is set, neighbours are visited by increasing degree. */
+static void bfs_order(const Graph& G, Node s, vector<int>& mark, int id, bool by_degree,
+	                  vector<Node>& out, vector<Dist>& level) {
+	size_t head = out.size();
+	vector<Node> next;
+	mark[s] = id;
+	level[s] = 0;
+	out.push_back(s);
+	while (head < out.size()) {
+		Node a = out[head++];
+		next.clear();
+		for (Node b: G.neighbours(a)) {
+			if (mark[b] != id) {
+				mark[b] = id;
+				level[b] = level[a] + 1;
+				next.push_back(b);
+			}
+		}
+		if (by_degree) {
+			stable_sort(begin(next), end(next), [&] (Node x, Node y) {
+				return G.degree(x) < G.degree(y);
+			});
+		}
+		out.insert(end(out), begin(next), end(next));
+	}
+}
+
+/* Reverse Cuthill-McKee. Each component starts at a pseudo-peripheral node
+   found by the heuristic of George and Liu. */
+static vector<Node> rcm_order(const Graph& G) {
+	int n = G.nnodes();
+	vector<Node> by_degree(n), order, comp;
+	iota(begin(by_degree), end(by_degree), 0);
+	stable_sort(begin(by_degree), end(by_degree), [&] (Node x, Node y) {
+		return G.degree(x) < G.degree(y);
+	});
+
+	vector<int> mark(n, 0);
+	vector<Dist> level(n, 0);
+	int id = 0;
+	for (Node start: by_degree) {
+		if (mark[start] != 0) {
+			continue;
+		}
+
+		/* Move to a node of minimum degree in the last BFS level as long as
+		   this increases the eccentricity. */
+		Node s = start;
+		comp.clear();
+		bfs_order(G, s, mark, ++id, false, comp, level);
+		for (;;) {
+			Dist ecc = level[comp.back()];
+			Node t = comp.back();
+			for (Node v: comp) {
+				if (level[v] == ecc && G.degree(v) < G.degree(t)) {
+					t = v;
+				}
+			}
+			comp.clear();
+			bfs_order(G, t, mark, ++id, false, comp, level);
+			if (level[comp.back()] <= ecc) {
+				break;
+			}
+			s = t;
+		}
+
+		comp.clear();
+		bfs_order(G, s, mark, ++id, true, comp, level);
+		order.insert(end(order), begin(comp), end(comp));
+	}
+	reverse(begin(order), end(order));
+	return order;
+}
+
+/* Greedy Gorder: repeatedly place the unplaced node with the largest score,
+   i.e. the number of edges and common neighbours with the last WINDOW placed
+   nodes. Scores are updated incrementally when nodes enter or leave the
+   window, common neighbours via hubs of very large degree are ignored. */
+static vector<Node> gorder_order(const Graph& G) {
+	const int WINDOW = 5;
+	int n = G.nnodes();
+	int hub_degree = max(16, int(sqrt(2.0 * G.nedges())));
+
+	vector<Node> by_degree(n), order;
+	iota(begin(by_degree), end(by_degree), 0);
+	stable_sort(begin(by_degree), end(by_degree), [&] (Node x, Node y) {
+		return G.degree(x) > G.degree(y);
+	});
+
+	/* Max-heap of (score, node) with lazy updates: every unplaced node with
+	   a positive score has an entry at least as large as its current score. */
+	vector<int> score(n, 0);
+	vector<bool> placed(n, false);
+	priority_queue<pair<int, Node>> heap;
+	auto update = [&] (Node u, int delta) {
+		auto change = [&] (Node v) {
+			if (!placed[v]) {
+				score[v] += delta;
+				if (delta > 0) {
+					heap.push({score[v], v});
+				}
+			}
+		};
+		for (Node w: G.neighbours(u)) {
+			change(w);
+			if (G.degree(w) <= hub_degree) {
+				for (Node v: G.neighbours(w)) {
+					change(v);
+				}
+			}
+		}
+	};
+
+	size_t next_unplaced = 0;
+	while (int(order.size()) < n) {
+		/* Best scored node, or the unplaced node with max. degree. */
+		Node u = -1;
+		while (!heap.empty() && u == -1) {
+			auto top = heap.top(); heap.pop();
+			Node v = top.second;
+			if (placed[v] || score[v] <= 0) {
+				continue;
+			} else if (top.first != score[v]) {
+				heap.push({score[v], v});
+			} else {
+				u = v;
+			}
+		}
+		while (u == -1) {
+			Node v = by_degree[next_unplaced++];
+			if (!placed[v]) {
+				u = v;
+			}
+		}
+
+		placed[u] = true;
+		order.push_back(u);
+		update(u, +1);
+		if (order.size() > size_t(WINDOW)) {
+			update(order[order.size() - WINDOW - 1], -1);
+		}
+	}
+	return order;
+}
+
+vector<Node> node_order(const Graph& G, Order strategy) {
+	int n = G.nnodes();
+	vector<Node> order(n);
+	iota(begin(order), end(order), 0);
+
+	if (strategy == Order::AUTO) {
+		strategy = (n >= 1024) ? Order::RCM : Order::NONE;
+	}
+	if (strategy == Order::BFS) {
+		vector<int> mark(n, 0);
+		vector<Dist> level(n, 0);
+		order.clear();
+		for (Node u = 0; u < n; ++u) {
+			if (mark[u] == 0) {
+				bfs_order(G, u, mark, 1, false, order, level);
+			}
+		}
+	} else if (strategy == Order::RCM) {
+		order = rcm_order(G);
+	} else if (strategy == Order::DEGREE) {
+		stable_sort(begin(order), end(order), [&] (Node x, Node y) {
+			return G.degree(x) > G.degree(y);
+		});
+	} else if (strategy == Order::GORDER) {
+		order = gorder_order(G);
+	}
+	return order;
+}
+
+Graph permute(const Graph& G, const vector<Node>& inv) {
+	int n = G.nnodes();
+	vector<Node> perm(n);
+	for (Node u = 0; u < n; ++u) {
+		perm[inv[u]] = u;
+	}
+
+	Graph H;
+	H.reserve_nodes(n);
+	for (Node u = 0; u < n; ++u) {
+		H.add_node(G.label(inv[u]));
+	}
+	for (Node u = 0; u < n; ++u) {
+		H.reserve_degree(u, G.degree(inv[u]));
+	}
+
+	/* Every edge once; loops are stored twice in the adjacency list. */
+	for (Node u = 0; u < n; ++u) {
+		int loops = 0;
+		for (Node v: G.neighbours(inv[u])) {
+			if (perm[v] > u) {
+				H.add_edge(u, perm[v]);
+			} else if (perm[v] == u && (loops++ % 2) == 0) {
+				H.add_edge(u, u);
+			}
+		}
+	}
+	H.compact();
+
+	/* Symmetry metadata moves with the nodes. */
+	if (!G.orbits().empty()) {
+		vector<int> orbits(n);
+		for (Node u = 0; u < n; ++u) {
+			orbits[u] = G.orbits()[inv[u]];
+		}
+		H.set_orbits(orbits);
+	}
+	return H;
+}
+
+Reordering reorder(Graph G, Order strategy) {
+	Reordering r;
+	r.inv = node_order(G, strategy);
+	r.perm.resize(r.inv.size());
+	bool identity = true;
+	for (Node u = 0; u < Node(r.inv.size()); ++u) {
+		r.perm[r.inv[u]] = u;
+		identity = identity && r.inv[u] == u;
+	}
+	r.G = identity ? move(G) : permute(G, r.inv);
+	return r;
+}
@@ -0,0 +1,47 @@
+#ifndef _REORDER_H
+#define _REORDER_H
+
+#include <vector>
+#include <string>
+#include "graph.h"
+
+/** reorder.h: Relabelling of nodes for better cache locality. */
+
+/**
+ * Strategies for the new node order:
+ *   NONE:   keep the input order,
+ *   BFS:    BFS order, one component after the other,
+ *   RCM:    reverse Cuthill-McKee (BFS from a peripheral node, neighbours by
+ *           increasing degree, reversed),
+ *   DEGREE: decreasing degree,
+ *   GORDER: greedy order that places nodes with many neighbours in common
+ *           close to each other (sliding window of size 5 as in Gorder),
+ *   AUTO:   RCM for large graphs, NONE otherwise.
+ */
+enum class Order { NONE, BFS, RCM, DEGREE, GORDER, AUTO };
+
+/* Parses "none", "bfs", "rcm", "degree", "gorder" or "auto". */
+Order parse_order(const std::string& name);
+
+/**
+ * Relabelled graph together with the permutation from (perm: old id -> new id)
+ * and back to (inv: new id -> old id) the original node ids.
+ * Labels move with their nodes.
+ */
+struct Reordering {
+	Graph G;
+	std::vector<Node> perm, inv;
+};
+
+/* Computes the new order of the nodes, i.e. inv, for the given strategy.
+   O(n log n + m) time except for GORDER (sum of squared degrees). */
+std::vector<Node> node_order(const Graph& G, Order strategy);
+
+/* Generates the graph where node inv[i] of G becomes node i in O(n + m) time. */
+Graph permute(const Graph& G, const std::vector<Node>& inv);
+
+/* Relabels G using the given strategy. If the new order is the identity (e.g.
+   NONE), G itself is moved into the result without a copy. */
+Reordering reorder(Graph G, Order strategy);
+
+#endif
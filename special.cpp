@@ -17,6 +17,7 @@ static int my_stoi(const string& s, int base) {
 
 Graph hypercube(int n) {
 	Graph G;
+	G.reserve_nodes(1 << n, n);
 
 	/* Consider all bit strings {0, 1}^n. */
 	for (Node u = 0; u < (1 << n); ++u) {
@@ -27,6 +28,7 @@ Graph hypercube(int n) {
 			}
 		}
 		G.add_node(label);
+		G.reserve_degree(u, n);
 	}
 
 	/* Edges between strings with Hamming distance 1. */
@@ -38,6 +40,7 @@ Graph hypercube(int n) {
 		}
 	}
 
+	G.set_vertex_transitive();
 	return G;
 }
 
@@ -67,10 +70,16 @@ Graph kneser(int n, int k) {
 		labels.push_back(label.str());
 	} while (next_permutation(begin(str), end(str)));
 
-	/* Connect disjoint sets. */
+	/* Connect disjoint sets; each set is disjoint from C(n - k, k) others. */
+	int degree = 1;
+	for (int i = 1; i <= k; ++i) {
+		degree = degree * (n - k - i + 1) / i;
+	}
 	Graph G;
+	G.reserve_nodes(int(nodes.size()), degree);
 	for (int i = 0; i < int(nodes.size()); ++i) {
 		G.add_node(labels[i]);
+		G.reserve_degree(i, degree);
 	}
 	for (Node u = 0; u < Node(nodes.size()); ++u) {
 		for (Node v = u + 1; v < Node(nodes.size()); ++v) {
@@ -80,6 +89,7 @@ Graph kneser(int n, int k) {
 		}
 	}
 
+	G.set_vertex_transitive();
 	return G;
 }
 
@@ -88,6 +98,7 @@ Graph empty_graph(int n) {
 	for (int i = 0; i < n; ++i) {
 		G.add_node();
 	}
+	G.set_vertex_transitive();
 	return G;
 }
 
@@ -97,22 +108,36 @@ Graph path(int n) {
 	for (Node u = 1; u <= n; ++u) {
 		G.add_edge(u, u-1);
 	}
+	G.compact();
+
+	/* Reflection maps u to n - u. */
+	vector<int> orbits(n + 1);
+	for (Node u = 0; u <= n; ++u) {
+		orbits[u] = min(u, n - u);
+	}
+	G.set_orbits(orbits);
 	return G;
 }
 
 Graph cycle(int n) {
 	Graph G = path(n - 1);
 	G.add_edge(0, n - 1);
+	G.compact();
+	G.set_vertex_transitive();
 	return G;
 }
 
 Graph complete_graph(int n) {
 	Graph G = empty_graph(n);
+	for (Node u = 0; u < n; ++u) {
+		G.reserve_degree(u, n - 1);
+	}
 	for (Node u = 0; u < n; ++u) {
 		for (Node v = u + 1; v < n; ++v) {
 			G.add_edge(u, v);
 		}
 	}
+	G.set_vertex_transitive();
 	return G;
 }
 
@@ -134,5 +159,11 @@ Graph complete_bipartite(int m, int n) {
 			G.add_edge(u, v + m);
 		}
 	}
+	G.compact();
+
+	/* The partite sets (one orbit if m = n). */
+	vector<int> orbits(m + n, 0);
+	fill(begin(orbits) + m, end(orbits), 1);
+	G.set_orbits(orbits);
 	return G;
 }
@@ -3,7 +3,8 @@
 
 #include "graph.h"
 
-/** special.h: Generators for special graphs. */
+/** special.h: Generators for special graphs. They set the symmetry metadata
+    (vertex transitive, orbits of paths and complete bipartite graphs). */
 
 /** Hypercube of dimension n. */
 Graph hypercube(int n);
@@ -0,0 +1,213 @@
+#include <cstdlib>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <numeric>
+#include <stdexcept>
+#include <algorithm>
+#include "stream.h"
+
+using namespace std;
+
+/* Adjacency entries that write_csr collects in memory per pass. */
+static const size_t CSR_BUFFER = size_t(1) << 24;
+
+/* Skips the node section and returns the number of nodes (largest id). */
+static int read_nodes(istream& in) {
+	string line;
+	int n = 0;
+	while (getline(in, line) && line != "#") {
+		if (line[0] == '#') {
+			continue; /* Symmetry metadata. */
+		}
+		long u = strtol(line.c_str(), nullptr, 10);
+		if (u <= 0) {
+			ostringstream error; error << "Node '" << u << "' is invalid";
+			throw runtime_error(error.str());
+		}
+		n = max(n, int(u));
+	}
+	return n;
+}
+
+/* Reads the next edge uv (0-based) of the edge section, skipping empty lines. */
+static bool read_edge(istream& in, int n, string& line, Node& u, Node& v) {
+	while (getline(in, line)) {
+		char* pos;
+		u = Node(strtol(line.c_str(), &pos, 10)) - 1;
+		v = Node(strtol(pos, &pos, 10)) - 1;
+		if (u == -1 && v == -1) {
+			continue;
+		} else if (u < 0 || u >= n || v < 0 || v >= n) {
+			ostringstream error; error << "Edge '" << line << "' is invalid";
+			throw runtime_error(error.str());
+		}
+		return true;
+	}
+	return false;
+}
+
+/* Union-find with union by rank and path compression. parity[u] is the
+   parity of the path from u to parent[u] in a spanning forest. */
+class ParityUnionFind {
+private:
+	vector<int> parent;
+	vector<uint8_t> rank, parity;
+
+public:
+	ParityUnionFind(int n) : parent(n), rank(n, 0), parity(n, 0) {
+		iota(begin(parent), end(parent), 0);
+	}
+
+	/* Returns the root of u and the parity p of the path from u to it. */
+	int find(int u, int& p) {
+		int root = u;
+		p = 0;
+		while (parent[root] != root) {
+			p ^= parity[root];
+			root = parent[root];
+		}
+		for (int x = u, px = p; x != root; ) {
+			int next = parent[x], pnext = px ^ parity[x];
+			parent[x] = root;
+			parity[x] = uint8_t(px);
+			x = next, px = pnext;
+		}
+		return root;
+	}
+
+	/* Adds edge uv. Returns 0 if it joins two trees, 1 if it closes an even
+	   cycle and 2 if it closes an odd cycle. */
+	int unite(int u, int v) {
+		int pu, pv;
+		int ru = find(u, pu), rv = find(v, pv);
+		if (ru == rv) {
+			return (pu == pv) ? 2 : 1;
+		}
+		if (rank[ru] < rank[rv]) {
+			swap(ru, rv);
+		}
+		parent[rv] = ru;
+		parity[rv] = uint8_t(pu ^ pv ^ 1);
+		if (rank[ru] == rank[rv]) {
+			rank[ru]++;
+		}
+		return 0;
+	}
+};
+
+StreamSummary stream_analyse(istream& in) {
+	StreamSummary s;
+	s.n = read_nodes(in);
+	s.m = 0;
+	s.degree.assign(s.n, 0);
+	s.components = s.n;
+	s.forest = s.bipartite = true;
+
+	ParityUnionFind uf(s.n);
+	string line;
+	Node u, v;
+	while (read_edge(in, s.n, line, u, v)) {
+		s.m++;
+		s.degree[u]++, s.degree[v]++;
+		int cycle = uf.unite(u, v);
+		if (cycle == 0) {
+			s.components--;
+		} else {
+			s.forest = false;
+			s.bipartite = s.bipartite && (cycle == 1);
+		}
+	}
+	return s;
+}
+
+void write_csr(istream& in, const StreamSummary& s, const string& filename) {
+	/* Degree order and offsets of the new nodes. */
+	vector<Node> id(s.n), perm(s.n);
+	iota(begin(id), end(id), 0);
+	stable_sort(begin(id), end(id), [&] (Node x, Node y) {
+		return s.degree[x] > s.degree[y];
+	});
+	vector<int64_t> offset(s.n + 1, 0);
+	for (Node u = 0; u < s.n; ++u) {
+		perm[id[u]] = u;
+		offset[u + 1] = offset[u] + s.degree[id[u]];
+	}
+
+	ofstream out(filename, ios::binary);
+	if (!out) {
+		throw runtime_error("Cannot write '" + filename + "'");
+	}
+	int64_t header[2] = {s.n, 2 * s.m};
+	out.write(reinterpret_cast<const char*>(header), sizeof(header));
+	out.write(reinterpret_cast<const char*>(offset.data()), offset.size() * sizeof(int64_t));
+
+	/* Further passes: the adjacency lists of a range of nodes are filled in
+	   a buffer, which is then written sequentially. Usually one pass. */
+	streampos start = in.tellg();
+	vector<int32_t> buffer;
+	for (Node first = 0, last; first < s.n; first = last) {
+		last = first + 1;
+		while (last < s.n && offset[last + 1] - offset[first] <= int64_t(CSR_BUFFER)) {
+			last++;
+		}
+		buffer.resize(size_t(offset[last] - offset[first]));
+		vector<int64_t> next(begin(offset) + first, begin(offset) + last);
+		auto put = [&] (Node a, Node b) {
+			Node x = perm[a];
+			if (x >= first && x < last) {
+				buffer[size_t(next[x - first]++ - offset[first])] = perm[b];
+			}
+		};
+
+		in.clear();
+		in.seekg(start);
+		read_nodes(in);
+		string line;
+		Node u, v;
+		while (read_edge(in, s.n, line, u, v)) {
+			put(u, v);
+			put(v, u);
+		}
+		out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(int32_t));
+	}
+
+	for (Node& x: id) {
+		x++;
+	}
+	out.write(reinterpret_cast<const char*>(id.data()), id.size() * sizeof(int32_t));
+}
+
+Graph read_csr(istream& in) {
+	int64_t header[2];
+	in.read(reinterpret_cast<char*>(header), sizeof(header));
+	int n = int(header[0]);
+	vector<int64_t> offset(n + 1);
+	vector<int32_t> adj(header[1]), id(n);
+	in.read(reinterpret_cast<char*>(offset.data()), offset.size() * sizeof(int64_t));
+	in.read(reinterpret_cast<char*>(adj.data()), adj.size() * sizeof(int32_t));
+	in.read(reinterpret_cast<char*>(id.data()), id.size() * sizeof(int32_t));
+	if (!in) {
+		throw runtime_error("Invalid CSR file");
+	}
+
+	Graph G;
+	G.reserve_nodes(n);
+	for (Node u = 0; u < n; ++u) {
+		ostringstream label; label << id[u];
+		G.add_node(label.str());
+		G.reserve_degree(u, int(offset[u + 1] - offset[u]));
+	}
+	for (Node u = 0; u < n; ++u) {
+		int loops = 0;
+		for (int64_t i = offset[u]; i < offset[u + 1]; ++i) {
+			if (adj[i] > u) {
+				G.add_edge(u, adj[i]);
+			} else if (adj[i] == u && (loops++ % 2) == 0) {
+				G.add_edge(u, u);
+			}
+		}
+	}
+	G.compact();
+	return G;
+}
@@ -0,0 +1,43 @@
+#ifndef _STREAM_H
+#define _STREAM_H
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include "graph.h"
+
+/**
+ * stream.h: Semi-external analysis of TGF files whose adjacency lists do not
+ * fit into memory. The edge section is read once and only O(n) memory is used.
+ */
+
+struct StreamSummary {
+	int n;                   /* #nodes */
+	long long m;             /* #edges */
+	std::vector<int> degree; /* Degree of every node. */
+	int components;          /* #connected components */
+	bool forest;             /* No cycles (including loops and parallel edges). */
+	bool bipartite;          /* No odd cycles. */
+};
+
+/* Reads a TGF graph in one pass (labels are skipped) and determines degrees,
+   connected components and whether the graph is a forest or bipartite using
+   a union-find structure with parities in O((n + m) alpha(n)) time. */
+StreamSummary stream_analyse(std::istream& in);
+
+/**
+ * Writes the graph as CSR file with the nodes ordered by decreasing degree,
+ * reading the TGF graph again from in (which must be seekable). The file is
+ * written sequentially: each pass over the edges fills the adjacency lists
+ * of the next nodes with up to 2^24 entries in memory, so besides O(n)
+ * memory it needs one pass per 64 MB of lists. Layout (integers in native
+ * byte order):
+ *   int64 n, int64 2m, int64 offset[n + 1], int32 adj[2m], int32 id[n]
+ * where id[u] is the TGF id of the new node u.
+ */
+void write_csr(std::istream& in, const StreamSummary& s, const std::string& filename);
+
+/* Reads a CSR file written by write_csr. Nodes are labelled by TGF id. */
+Graph read_csr(std::istream& in);
+
+#endif
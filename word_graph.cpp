@@ -1,58 +1,126 @@
 #include <iostream>
+#include <fstream>
 #include <string>
 #include <utility>
-#include <cassert>
+#include <map>
+#include <future>
+#include <numeric>
+#include <iterator>
+#include <stdexcept>
 #include <cctype>
+#include <cstdio>
+#include <cstdlib>
 #include <sstream>
 #include <algorithm>
 #include <iomanip>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "graph.h"
 #include "bfs.h"
 #include "properties.h"
+#include "reorder.h"
+#include "pool.h"
 
 using namespace std;
 
 /** word_graph.cpp: Program for generating and analysing a word graph. */
 
-/** Computes the Hamming distance of s1 and s2. */
-int hamming(const string& s1, const string& s2) {
-	assert(s1.size() == s2.size());
-	int diff = 0;
-	for (size_t i = 0; i < s1.size(); ++i) {
-		if (s1[i] != s2[i]) {
-			diff++;
+/**
+ * Splits a dictionary into words, grouped by their length.
+ * Definition of a word: first space-delimited string on a line starting with
+ * an alphabetic character. It is normalised to lower case.
+ */
+map<int, vector<string>> read_words(const char* data, size_t size) {
+	map<int, vector<string>> words;
+	const char* stop = data + size;
+	for (const char* line = data; line < stop; ) {
+		const char* eol = find(line, stop, '\n');
+		if (isalpha((unsigned char) *line)) {
+			const char* word_end = line;
+			while (word_end < eol && !isspace((unsigned char) *word_end)) {
+				word_end++;
+			}
+			string word(line, word_end);
+			transform(begin(word), end(word), begin(word), ::tolower);
+			words[int(word.size())].push_back(word);
+		}
+		line = eol + 1;
+	}
+	return words;
+}
+
+/** Reads a dictionary file via mmap (whole stdin for "-") and splits it into words. */
+map<int, vector<string>> read_dictionary(const string& filename) {
+	if (filename == "-") {
+		string data((istreambuf_iterator<char>(cin)), istreambuf_iterator<char>());
+		return read_words(data.data(), data.size());
+	}
+
+	int fd = open(filename.c_str(), O_RDONLY);
+	struct stat st;
+	if (fd < 0 || fstat(fd, &st) != 0) {
+		throw runtime_error("Cannot read '" + filename + "'");
+	}
+	size_t size = size_t(st.st_size);
+	map<int, vector<string>> words;
+	if (size > 0) {
+		void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED) {
+			close(fd);
+			throw runtime_error("Cannot map '" + filename + "'");
 		}
+		words = read_words(static_cast<const char*>(data), size);
+		munmap(data, size);
 	}
-	return diff;
+	close(fd);
+	return words;
 }
 
 /**
- * Reads the word graph from the stream 'in'.
- *   nodes: words of length word_length.
+ * Generates the word graph of words of equal length.
+ *   nodes: the words in the given order.
  *   edges: between words of Hamming distance 1.
+ * For every position i, the words are sorted with position i ignored; words
+ * of distance 1 differing at i are then neighbours in this order.
+ * O(L^2 n log n + m) time for n words of length L.
  */
-Graph read_graph(istream& in, int word_length) {
+Graph word_graph(const vector<string>& words) {
 	Graph G;
+	int n = int(words.size());
+	G.reserve_nodes(n);
+	for (const string& word: words) {
+		G.add_node(word);
+	}
+	if (n == 0) {
+		return G;
+	}
 
-	/* Definition of a word: first space-delimited string on a line starting with
-	   an alphabetic character. It is normalised to lower case. */
-	string line, word;
-	while (getline(in, line)) {
-		if (line.length() > 0 && isalpha(line[0])) {
-			istringstream(line) >> word;
-			transform(begin(word), end(word), begin(word), ::tolower);
-
-			if (int(word.length()) == word_length) {
-				Node u = G.add_node(word);
+	size_t length = words[0].size();
+	vector<Node> order(n);
+	for (size_t i = 0; i < length; ++i) {
+		/* Compare without position i. */
+		auto less = [&] (Node u, Node v) {
+			int c = words[u].compare(0, i, words[v], 0, i);
+			return (c != 0) ? c < 0 : words[u].compare(i + 1, string::npos, words[v], i + 1, string::npos) < 0;
+		};
+		iota(begin(order), end(order), 0);
+		sort(begin(order), end(order), less);
 
-				for (Node v = 0; v < G.nnodes() - 1; ++v) {
-					if (hamming(word, G.label(v)) == 1) {
-						G.add_edge(u, v);
+		/* Connect distinct words within each bucket of equal keys. */
+		for (int first = 0, last; first < n; first = last) {
+			for (last = first + 1; last < n && !less(order[first], order[last]); ++last) {}
+			for (int a = first; a < last; ++a) {
+				for (int b = a + 1; b < last; ++b) {
+					if (words[order[a]][i] != words[order[b]][i]) {
+						G.add_edge(order[a], order[b]);
 					}
 				}
 			}
 		}
 	}
+	G.compact();
 	return G;
 }
 
@@ -67,6 +135,7 @@ vector<Summary> analyse_connectivity(const Graph& G) {
 	int ncomps = 0;
 	int n = G.nnodes();
 	vector<int> component(n, -1), eccentricity(n, 0);
+	BFSScratch scratch;
 	for (Node u = 0; u < n; ++u) {
 		int& ecc = eccentricity[u];
 		int cur_comp = (component[u] != -1) ? component[u] : (ncomps++);
@@ -74,7 +143,7 @@ vector<Summary> analyse_connectivity(const Graph& G) {
 		bfs(G, u, [&] (Node v, Dist d) {
 			component[v] = cur_comp;
 			ecc = max(ecc, d);
-		});
+		}, scratch);
 	}
 
 	/* Create summary for each component: order, diameter and representative node. */
@@ -88,28 +157,121 @@ vector<Summary> analyse_connectivity(const Graph& G) {
 	return summaries;
 }
 
-int main(int argc, char** argv) {
-	/* Read and analyse the word graph. */
-	cout << "Usage: " << argv[0] << " [word length] < dict.txt\n";
-	int word_length = 3;
-	if (argc >= 2) {
-		sscanf(argv[1], "%d", &word_length);
-	}
-	Graph G = read_graph(cin, word_length);
+/** Prints the analysis of the word graph G of words of length word_length. */
+void report(ostream& out, const Graph& G, int word_length) {
 	auto summaries = analyse_connectivity(G);
 
 	/* Print components. */
-	cout << "Word graph with " << G.nnodes() << " words of length " << word_length << "\n";
-	cout << " - " << G.nedges() << " edges\n";
+	out << "Word graph with " << G.nnodes() << " words of length " << word_length << "\n";
+	out << " - " << G.nedges() << " edges\n";
 	Node max_node = maximum_degree(G);
-	cout << " - Node with max. degree " << G.degree(max_node) << ": " << G.label(max_node) << "\n";
+	if (G.nnodes() > 0) {
+		out << " - Node with max. degree " << G.degree(max_node) << ": " << G.label(max_node) << "\n";
+	}
 
-	cout << summaries.size() << " components:\n";
+	out << summaries.size() << " components:\n";
 	sort(begin(summaries), end(summaries), [] (const Summary& s1, const Summary& s2) {
 		return s1.order > s2.order;
 	});
 	for (Summary s: summaries) {
-		cout << " - Order " << setw(3) << s.order << " with diameter " << setw(2) << s.diam << " (representative: " << s.repr << ")\n";
+		out << " - Order " << setw(3) << s.order << " with diameter " << setw(2) << s.diam << " (representative: " << s.repr << ")\n";
+	}
+}
+
+int main(int argc, char** argv) {
+	/* Read and analyse the word graph. */
+	cout << "Usage: " << argv[0] << " [word length | --all] [--order=none|bfs|rcm|degree|gorder|auto]"
+	     << " [--jobs=N] [--out=dir] [dict.txt ...] (default: dictionary from stdin)\n";
+	int word_length = 3, njobs = 0;
+	bool all = false;
+	Order order = Order::NONE;
+	string out_dir;
+	vector<string> files;
+	for (int i = 1; i < argc; ++i) {
+		string arg = argv[i];
+		if (arg.compare(0, 8, "--order=") == 0) {
+			try {
+				order = parse_order(arg.substr(8));
+			} catch (const runtime_error&) {
+				cerr << "Unknown option '" << arg << "'\n";
+				return 1;
+			}
+		} else if (arg == "--all") {
+			all = true;
+		} else if (arg.compare(0, 7, "--jobs=") == 0) {
+			njobs = atoi(arg.c_str() + 7);
+		} else if (arg.compare(0, 6, "--out=") == 0) {
+			out_dir = arg.substr(6);
+		} else if (!arg.empty() && files.empty() && all_of(begin(arg), end(arg), [] (char c) {
+				return isdigit((unsigned char) c) != 0;
+			})) {
+			/* Word length; e.g. '2of12.txt' is a file name. */
+			sscanf(argv[i], "%d", &word_length);
+		} else {
+			files.push_back(arg);
+		}
+	}
+	if (files.empty()) {
+		files.push_back("-");
+	}
+
+	/* Every file is read once, before any analysis starts. */
+	vector<map<int, vector<string>>> dictionaries;
+	dictionaries.reserve(files.size());
+	for (const string& file: files) {
+		try {
+			dictionaries.push_back(read_dictionary(file));
+		} catch (const runtime_error& e) {
+			cerr << e.what() << "\n";
+			return 1;
+		}
+	}
+
+	/* The graphs of all (selected) lengths of all files are built and
+	   analysed concurrently. */
+	ThreadPool pool(njobs);
+	vector<pair<string, future<string>>> reports;
+	for (size_t i = 0; i < files.size(); ++i) {
+		const string& file = files[i];
+		auto& words = dictionaries[i];
+		if (!all) {
+			words[word_length]; /* Report even if there are no such words. */
+		}
+		for (auto& length: words) {
+			if (!all && length.first != word_length) {
+				continue;
+			}
+			int len = length.first;
+			const vector<string>& list = length.second;
+			ostringstream name;
+			string base = file.substr(file.find_last_of('/') + 1);
+			name << base.substr(0, base.rfind(".txt")) << "." << len << ".out";
+			reports.push_back({name.str(), pool.submit([&list, len, order] () {
+				ostringstream out;
+				report(out, reorder(word_graph(list), order).G, len);
+				return out.str();
+			})});
+		}
+	}
+
+	/* Write the reports to separate files or, in order, to stdout. */
+	int status = 0;
+	for (auto& r: reports) {
+		if (out_dir != "") {
+			string path = out_dir + "/" + r.first;
+			ofstream out(path);
+			out << r.second.get();
+			out.close();
+			if (!out) {
+				cerr << "Cannot write '" << path << "'\n";
+				status = 1;
+			}
+		} else {
+			if (reports.size() > 1) {
+				cout << "== " << r.first << "\n";
+			}
+			cout << r.second.get();
+		}
 	}
-	return 0;
+	return status;
 }
@@ -1,8 +1,5 @@
 #!/bin/sh
 
-cd dict
-for i in *.txt
-do
-	../word_graph < $i > ../out/${i%.txt}.out
-done
-
+# One run for all dictionaries and word lengths: writes out/<dict>.<length>.out
+mkdir -p out
+./word_graph --all --out=out dict/*.txt > /dev/null